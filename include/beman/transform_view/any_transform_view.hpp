@@ -0,0 +1,354 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_ANY_TRANSFORM_VIEW_HPP
+#define BEMAN_TRANSFORM_VIEW_ANY_TRANSFORM_VIEW_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <span>
+#endif
+
+namespace beman::transform_view {
+
+namespace detail {
+
+// Calls through a pointer to a non-tidy F, so that the per-chunk kernel can
+// build a transform_view without copying F.
+template <typename F>
+struct fn_ref {
+    const F* f_;
+
+    template <typename T>
+    constexpr decltype(auto) operator()(T&& x) const {
+        return std::invoke(*f_, (T&&)x);
+    }
+};
+
+// The loop every erased call_n() runs; it is the same iterator loop any
+// statically typed transform_view consumer would run.
+template <typename In, typename Out, typename F>
+void transform_n(const F& f, const In* first, std::size_t n, Out* out) {
+    std::span<const In> in(first, n);
+    if constexpr (tidy_func<F>)
+        std::ranges::copy(beman::transform_view::transform_view(in, F()), out);
+    else
+        std::ranges::copy(
+            beman::transform_view::transform_view(in, fn_ref<F>{&f}), out);
+}
+
+template <typename In, typename Out>
+struct any_fn_vtable {
+    Out (*call)(const void*, const In&);
+    void (*call_n)(const void*, const In*, std::size_t, Out*);
+    void (*copy)(const void*, void*);
+    void (*move)(void*, void*) noexcept;
+    void (*destroy)(void*) noexcept;
+};
+
+inline constexpr std::size_t any_fn_buffer_size = 3 * sizeof(void*);
+
+template <typename F>
+constexpr bool any_fn_is_local =
+    sizeof(F) <= any_fn_buffer_size &&
+    alignof(F) <= alignof(std::max_align_t) &&
+    std::is_nothrow_move_constructible_v<F>;
+
+template <typename In, typename Out, typename F>
+struct any_fn_ops {
+    static constexpr bool local = any_fn_is_local<F>;
+
+    static const F& get(const void* storage) {
+        if constexpr (local)
+            return *static_cast<const F*>(storage);
+        else
+            return **static_cast<F* const*>(storage);
+    }
+
+    static Out call(const void* storage, const In& x) {
+        return std::invoke(get(storage), x);
+    }
+    static void
+    call_n(const void* storage, const In* first, std::size_t n, Out* out) {
+        detail::transform_n(get(storage), first, n, out);
+    }
+    static void copy(const void* from, void* to) {
+        if constexpr (local)
+            ::new (to) F(get(from));
+        else
+            *static_cast<F**>(to) = new F(get(from));
+    }
+    static void move(void* from, void* to) noexcept {
+        if constexpr (local) {
+            ::new (to) F(std::move(*static_cast<F*>(from)));
+            static_cast<F*>(from)->~F();
+        } else {
+            *static_cast<F**>(to) = *static_cast<F**>(from);
+        }
+    }
+    static void destroy(void* storage) noexcept {
+        if constexpr (local)
+            static_cast<F*>(storage)->~F();
+        else
+            delete *static_cast<F**>(storage);
+    }
+
+    static constexpr any_fn_vtable<In, Out> vtable = {
+        &call, &call_n, &copy, &move, &destroy};
+};
+
+// A copyable, type-erased In -> Out callable.  Small callables live in the
+// in-object buffer; larger ones (or ones with throwing moves) go on the
+// heap.
+template <typename In, typename Out>
+class any_fn {
+  public:
+    any_fn() = default;
+
+    template <typename F>
+        requires(!std::same_as<std::remove_cvref_t<F>, any_fn>)
+    explicit any_fn(F&& f) {
+        using Fn = std::remove_cvref_t<F>;
+        if constexpr (any_fn_is_local<Fn>)
+            ::new (static_cast<void*>(buffer_)) Fn((F&&)f);
+        else
+            *reinterpret_cast<Fn**>(buffer_) = new Fn((F&&)f);
+        vtable_ = &any_fn_ops<In, Out, Fn>::vtable;
+    }
+
+    any_fn(const any_fn& other) : vtable_(other.vtable_) {
+        if (vtable_)
+            vtable_->copy(other.buffer_, buffer_);
+    }
+    any_fn(any_fn&& other) noexcept : vtable_(other.vtable_) {
+        if (vtable_)
+            vtable_->move(other.buffer_, buffer_);
+        other.vtable_ = nullptr;
+    }
+    any_fn& operator=(const any_fn& other) {
+        if (this != std::addressof(other)) {
+            any_fn tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+    any_fn& operator=(any_fn&& other) noexcept {
+        if (this != std::addressof(other)) {
+            reset();
+            if (other.vtable_)
+                other.vtable_->move(other.buffer_, buffer_);
+            vtable_       = other.vtable_;
+            other.vtable_ = nullptr;
+        }
+        return *this;
+    }
+    ~any_fn() { reset(); }
+
+    explicit operator bool() const noexcept { return vtable_ != nullptr; }
+
+    Out operator()(const In& x) const { return vtable_->call(buffer_, x); }
+
+    // Does nothing when n is 0, even without a callable, so that an empty
+    // any_transform_view can be copied.
+    void operator()(const In* first, std::size_t n, Out* out) const {
+        if (n != 0)
+            vtable_->call_n(buffer_, first, n, out);
+    }
+
+  private:
+    void reset() noexcept {
+        if (vtable_)
+            vtable_->destroy(buffer_);
+        vtable_ = nullptr;
+    }
+
+    alignas(std::max_align_t) std::byte buffer_[any_fn_buffer_size];
+    const any_fn_vtable<In, Out>* vtable_ = nullptr;
+};
+
+} // namespace detail
+
+/** A transform_view over a contiguous sequence of `In` whose callable is
+    chosen at run time.  The callable is type-erased, and stored in a small
+    in-object buffer when it fits.
+
+    Element-wise iteration works as with any other view, but costs one
+    indirect call per element.  The bulk operations `transform()`, `copy()`
+    and `for_each_chunk()` instead make one indirect call per chunk; each such
+    call runs the statically typed transform_view loop for the erased
+    callable, so throughput is close to that of an unerased
+    transform_view. */
+template <typename In, typename Out>
+    requires std::is_object_v<In> && std::is_object_v<Out> &&
+             std::move_constructible<Out>
+class any_transform_view
+    : public std::ranges::view_interface<any_transform_view<In, Out> > {
+    using fn_type = detail::any_fn<In, Out>;
+
+  public:
+    /** The number of elements `for_each_chunk()` materializes at a time. */
+    static constexpr std::size_t chunk_size = 256;
+
+    class iterator {
+        const In*      current_ = nullptr;
+        const fn_type* fn_      = nullptr;
+
+      public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = Out;
+        using difference_type   = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(const In* current, const fn_type& fn)
+            : current_(current), fn_(std::addressof(fn)) {}
+
+        const In* base() const noexcept { return current_; }
+
+        Out operator*() const { return (*fn_)(*current_); }
+        Out operator[](difference_type n) const {
+            return (*fn_)(current_[n]);
+        }
+
+        iterator& operator++() {
+            ++current_;
+            return *this;
+        }
+        iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        iterator& operator--() {
+            --current_;
+            return *this;
+        }
+        iterator operator--(int) {
+            auto tmp = *this;
+            --*this;
+            return tmp;
+        }
+        iterator& operator+=(difference_type n) {
+            current_ += n;
+            return *this;
+        }
+        iterator& operator-=(difference_type n) {
+            current_ -= n;
+            return *this;
+        }
+
+        friend bool operator==(const iterator& x, const iterator& y) {
+            return x.current_ == y.current_;
+        }
+        friend auto operator<=>(const iterator& x, const iterator& y) {
+            return x.current_ <=> y.current_;
+        }
+
+        friend iterator operator+(iterator i, difference_type n) {
+            return i += n;
+        }
+        friend iterator operator+(difference_type n, iterator i) {
+            return i += n;
+        }
+        friend iterator operator-(iterator i, difference_type n) {
+            return i -= n;
+        }
+        friend difference_type operator-(const iterator& x,
+                                         const iterator& y) {
+            return x.current_ - y.current_;
+        }
+    };
+
+    /** Default constructor.  The result is empty, and has no callable. */
+    any_transform_view() = default;
+
+    /** Construct from `base` and `fun`.  `fun` is moved into `*this`. */
+    template <typename F>
+        requires(!std::same_as<std::remove_cvref_t<F>, any_transform_view>) &&
+                std::copy_constructible<std::remove_cvref_t<F>> &&
+                std::regular_invocable<const std::remove_cvref_t<F>&,
+                                       const In&> &&
+                std::convertible_to<
+                    std::invoke_result_t<const std::remove_cvref_t<F>&,
+                                         const In&>,
+                    Out>
+    any_transform_view(std::span<const In> base, F&& fun)
+        : base_(base), fun_((F&&)fun) {}
+
+    /** Returns the underlying elements. */
+    std::span<const In> base() const noexcept { return base_; }
+
+    /** Returns an iterator for the beginning of `*this`. */
+    iterator begin() const { return iterator(base_.data(), fun_); }
+
+    /** Returns an iterator for the end of `*this`. */
+    iterator end() const {
+        return iterator(base_.data() + base_.size(), fun_);
+    }
+
+    /** Returns the number of elements in `*this`. */
+    std::size_t size() const noexcept { return base_.size(); }
+
+    /** Applies the callable to each element of `in`, writing the results to
+        the corresponding elements of `out`, with a single indirect call.
+
+        \pre `in.size() <= out.size()`, and `*this` has a callable unless
+        `in` is empty. */
+    void transform(std::span<const In> in, std::span<Out> out) const {
+        fun_(in.data(), in.size(), out.data());
+    }
+
+    /** Writes all the elements of `*this` to `out`, with a single indirect
+        call.  Returns the unused remainder of `out`.
+
+        \pre `size() <= out.size()` */
+    std::span<Out> copy(std::span<Out> out) const {
+        fun_(base_.data(), base_.size(), out.data());
+        return out.subspan(base_.size());
+    }
+
+    /** Materializes `*this` `chunk_size` elements at a time, making one
+        indirect call per chunk, and passes each chunk to `g` as a
+        `std::span<const Out>`. */
+    template <typename G>
+        requires std::default_initializable<Out> &&
+                 std::invocable<G&, std::span<const Out> >
+    void for_each_chunk(G g) const {
+        Out         buffer[chunk_size];
+        std::size_t offset = 0;
+        while (offset < base_.size()) {
+            const std::size_t n =
+                (std::min)(chunk_size, base_.size() - offset);
+            fun_(base_.data() + offset, n, buffer);
+            std::invoke(g, std::span<const Out>(buffer, n));
+            offset += n;
+        }
+    }
+
+  private:
+    std::span<const In> base_;
+    fn_type             fun_;
+};
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_ANY_TRANSFORM_VIEW_HPP
@@ -0,0 +1,269 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_ARENA_HPP
+#define BEMAN_TRANSFORM_VIEW_ARENA_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+#include <beman/transform_view/batch.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+// Transparent huge pages are requested with madvise() on Linux; elsewhere
+// (and in the modules build) the request is ignored.
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES() && defined(__linux__) && \
+    __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#define BEMAN_TRANSFORM_VIEW_MADVISE_HUGEPAGE 1
+#else
+#define BEMAN_TRANSFORM_VIEW_MADVISE_HUGEPAGE 0
+#endif
+
+namespace beman::transform_view {
+
+/** Selects whether a `bump_arena` asks the OS to back its blocks with huge
+    pages. */
+enum class arena_pages { normal, huge };
+
+/** A `std::pmr::memory_resource` that hands out memory by bumping a pointer
+    through large blocks obtained from an upstream resource, and frees
+    nothing until `reset()` or `release()`.
+
+    Unlike `std::pmr::monotonic_buffer_resource`, `reset()` keeps the blocks,
+    so an arena that is reset after each request reuses memory that is
+    already mapped and faulted in, instead of returning it to the upstream
+    resource and touching fresh pages next time.  With `arena_pages::huge`,
+    blocks are a multiple of 2 MiB, aligned to 2 MiB, and (on Linux)
+    advised with `madvise(MADV_HUGEPAGE)`, so that large materializations
+    take fewer page faults and TLB misses.  An arena is not thread-safe;
+    see `thread_arena()`. */
+class bump_arena : public std::pmr::memory_resource {
+  public:
+    /** The default size of each block, in bytes. */
+    static constexpr std::size_t default_block_size = std::size_t(1) << 20;
+
+    /** The size and alignment of a huge page. */
+    static constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+
+    /** Constructs an arena that allocates blocks of at least `block_size`
+        bytes from `upstream`. */
+    explicit bump_arena(
+        std::size_t                block_size = default_block_size,
+        arena_pages                pages      = arena_pages::normal,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : block_size_(block_size), pages_(pages), upstream_(upstream) {}
+
+    bump_arena(const bump_arena&)            = delete;
+    bump_arena& operator=(const bump_arena&) = delete;
+
+    ~bump_arena() override { release(); }
+
+    /** Makes all of the arena's memory available again, without returning
+        any of it to the upstream resource.  Everything allocated from the
+        arena must no longer be in use. */
+    void reset() noexcept {
+        current_ = 0;
+        next_    = blocks_.empty() ? nullptr : blocks_[0].first;
+        end_     = blocks_.empty() ? nullptr : next_ + blocks_[0].second;
+    }
+
+    /** Returns all of the arena's memory to the upstream resource. */
+    void release() noexcept {
+        for (auto [p, size] : blocks_)
+            upstream_->deallocate(p, size, block_alignment());
+        blocks_.clear();
+        reset();
+    }
+
+    /** Returns the total size of the blocks the arena holds. */
+    std::size_t capacity() const noexcept {
+        std::size_t n = 0;
+        for (const auto& block : blocks_)
+            n += block.second;
+        return n;
+    }
+
+    /** Returns the upstream resource. */
+    std::pmr::memory_resource* upstream_resource() const noexcept {
+        return upstream_;
+    }
+
+  private:
+    std::size_t block_alignment() const noexcept {
+        return pages_ == arena_pages::huge ? huge_page_size
+                                           : alignof(std::max_align_t);
+    }
+
+    static std::byte* align_up(std::byte* p, std::size_t alignment) noexcept {
+        const auto n = reinterpret_cast<std::uintptr_t>(p);
+        return p + ((alignment - n % alignment) % alignment);
+    }
+
+    // Makes the block at current_ the one allocations come from.
+    void use_block() noexcept {
+        next_ = blocks_[current_].first;
+        end_  = next_ + blocks_[current_].second;
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        for (;;) {
+            if (next_ != nullptr) {
+                std::byte* p = align_up(next_, alignment);
+                if (bytes <= std::size_t(end_ - p)) {
+                    next_ = p + bytes;
+                    return p;
+                }
+            }
+            if (next_ != nullptr && current_ + 1 < blocks_.size()) {
+                ++current_;
+                use_block();
+            } else {
+                add_block(bytes + alignment);
+            }
+        }
+    }
+
+    // Adds a block of at least min_size bytes after the current one, and
+    // makes it current.
+    void add_block(std::size_t min_size) {
+        std::size_t size = min_size < block_size_ ? block_size_ : min_size;
+        if (pages_ == arena_pages::huge)
+            size = (size + huge_page_size - 1) / huge_page_size *
+                   huge_page_size;
+        auto* p = static_cast<std::byte*>(
+            upstream_->allocate(size, block_alignment()));
+#if BEMAN_TRANSFORM_VIEW_MADVISE_HUGEPAGE
+        if (pages_ == arena_pages::huge)
+            ::madvise(p, size, MADV_HUGEPAGE); // Only a hint; may fail.
+#endif
+        // Blocks skipped over by an oversized request stay later in the
+        // list, to be used after the next reset().
+        const std::size_t at = next_ == nullptr ? 0 : current_ + 1;
+        blocks_.emplace(blocks_.begin() + std::ptrdiff_t(at), p, size);
+        current_ = at;
+        use_block();
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::size_t                                      block_size_;
+    arena_pages                                      pages_;
+    std::pmr::memory_resource*                       upstream_;
+    std::vector<std::pair<std::byte*, std::size_t> > blocks_;
+    std::size_t                                      current_ = 0;
+    std::byte*                                       next_    = nullptr;
+    std::byte*                                       end_     = nullptr;
+};
+
+/** Returns a `bump_arena` owned by the calling thread, with the default
+    block size and normal pages.  Calling `reset()` on it at the end of each
+    unit of work gives each thread allocation-free, contention-free
+    temporaries from then on. */
+inline bump_arena& thread_arena() {
+    thread_local bump_arena arena;
+    return arena;
+}
+
+namespace detail {
+
+template <typename C>
+concept pmr_container =
+    requires { typename C::allocator_type; } &&
+    std::constructible_from<typename C::allocator_type,
+                            std::pmr::memory_resource*> &&
+    std::constructible_from<C, typename C::allocator_type>;
+
+} // namespace detail
+
+/** Copies the elements of `r` into memory allocated from `mr`, in a single
+    allocation of exactly `std::ranges::size(r)` elements, and returns them
+    as a `std::span`.  The elements are never destroyed, so they must be
+    trivially destructible; the memory is freed with `mr`, e.g. by resetting
+    a `bump_arena`.  Batch-capable views (see `batch_copy()`) are evaluated a
+    batch at a time. */
+template <std::ranges::input_range R>
+    requires std::ranges::sized_range<R> &&
+             std::is_trivially_destructible_v<std::ranges::range_value_t<R> > &&
+             std::constructible_from<std::ranges::range_value_t<R>,
+                                     std::ranges::range_reference_t<R> >
+std::span<std::ranges::range_value_t<R> >
+to_arena(R&& r, std::pmr::memory_resource& mr) {
+    using T      = std::ranges::range_value_t<R>;
+    const auto n = std::size_t(std::ranges::size(r));
+    if (n == 0)
+        return {};
+
+    std::pmr::polymorphic_allocator<T> alloc(&mr);
+    T*                                 p = alloc.allocate(n);
+    if constexpr (std::is_trivially_copyable_v<T> &&
+                  std::is_trivially_default_constructible_v<T> &&
+                  std::indirectly_copyable<std::ranges::iterator_t<R>, T*>) {
+        // The allocation implicitly creates the T objects.
+        beman::transform_view::batch_copy(r, p);
+    } else {
+        T* out = p;
+        try {
+            for (auto&& x : r)
+                std::construct_at(out++, (decltype(x)&&)x);
+        } catch (...) {
+            alloc.deallocate(p, n);
+            throw;
+        }
+    }
+    return std::span<T>(p, n);
+}
+
+/** Returns the elements of `r` in a `C` that allocates from `mr`, e.g. a
+    `std::pmr::vector` or `std::pmr::string`.  If `C` is contiguous and can
+    be resized, it is sized exactly once, to `std::ranges::size(r)`, and
+    filled with `batch_copy()`; otherwise it reserves that size first if it
+    can, and the elements are inserted at its end. */
+template <typename C, std::ranges::input_range R>
+    requires detail::pmr_container<C>
+C to_arena(R&& r, std::pmr::memory_resource& mr) {
+    C c{typename C::allocator_type(&mr)};
+    if constexpr (std::ranges::sized_range<R> &&
+                  std::ranges::contiguous_range<C> &&
+                  requires { c.resize(std::ranges::size(r)); }) {
+        c.resize(std::size_t(std::ranges::size(r)));
+        beman::transform_view::batch_copy(r, std::ranges::begin(c));
+    } else {
+        if constexpr (std::ranges::sized_range<R> &&
+                      requires { c.reserve(std::ranges::size(r)); })
+            c.reserve(std::size_t(std::ranges::size(r)));
+        beman::transform_view::batch_for_each(
+            r, [&c](auto&& x) { c.insert(c.end(), (decltype(x)&&)x); });
+    }
+    return c;
+}
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_ARENA_HPP
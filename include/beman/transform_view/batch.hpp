@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_BATCH_HPP
+#define BEMAN_TRANSFORM_VIEW_BATCH_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#endif
+
+namespace beman::transform_view {
+
+/** True iff `F` can be called on a whole batch of inputs at once, as
+    `f(std::span<const In>(...), std::span<Out>(...))`, writing `f(in[i])` to
+    `out[i]` for each `i`.  `out` is always exactly as long as `in`. */
+template <typename F, typename In, typename Out>
+concept batch_invocable =
+    std::invocable<F, std::span<const In>, std::span<Out> >;
+
+/** The number of bytes of output the batch algorithms below produce per
+    call to a batch callable.  It is chosen so that a batch and its inputs
+    stay in L1 or L2 cache while they are consumed. */
+inline constexpr std::size_t batch_bytes = 16 * 1024;
+
+namespace detail {
+
+template <typename R>
+using batch_base_iterator_t = std::remove_cvref_t<
+    decltype(std::ranges::begin(std::declval<R&>()).base())>;
+
+template <typename R>
+using batch_fun_t =
+    decltype(view_access::fun(std::declval<std::remove_reference_t<R>&>()));
+
+// True iff R is a sized transform_view over a contiguous range whose
+// callable has a batch overload producing R's value type.
+template <typename R>
+concept batch_view =
+    transform_view_traits<std::remove_cvref_t<R> >::is_transform_view &&
+    std::ranges::sized_range<R> &&
+    std::contiguous_iterator<batch_base_iterator_t<R> > &&
+    std::default_initializable<std::ranges::range_value_t<R> > &&
+    std::movable<std::ranges::range_value_t<R> > &&
+    batch_invocable<batch_fun_t<R>,
+                    std::iter_value_t<batch_base_iterator_t<R> >,
+                    std::ranges::range_value_t<R> >;
+
+template <typename O, typename T>
+concept contiguous_output =
+    std::contiguous_iterator<O> && std::same_as<std::iter_reference_t<O>, T&>;
+
+template <typename T>
+constexpr std::size_t batch_size() noexcept {
+    return (std::max)(std::size_t(1), batch_bytes / sizeof(T));
+}
+
+// Calls sink(in, batch) for consecutive spans in of at most batch_size<Out>()
+// elements of the base of r, where batch(in, out) calls r's callable on in.
+template <typename R, typename Sink>
+constexpr void for_each_input_batch(R& r, Sink sink) {
+    using F   = typename transform_view_traits<
+        std::remove_cvref_t<R> >::func_type;
+    using In  = std::iter_value_t<batch_base_iterator_t<R> >;
+    using Out = std::ranges::range_value_t<R>;
+
+    const In*   first = std::to_address(std::ranges::begin(r).base());
+    std::size_t n     = std::size_t(std::ranges::size(r));
+    auto        call  = [&](batch_fun_t<R> f) {
+        auto batch = [&f](std::span<const In> in, std::span<Out> out) {
+            std::invoke(f, in, out);
+        };
+        for (const std::size_t size = batch_size<Out>(); n != 0;) {
+            const std::size_t m = (std::min)(n, size);
+            sink(std::span<const In>(first, m), batch);
+            first += m;
+            n -= m;
+        }
+    };
+    if constexpr (tidy_func<F>) {
+        F f;
+        call(f);
+    } else {
+        call(view_access::fun(r));
+    }
+}
+
+// Calls g(values) for consecutive batches of the elements of r, where values
+// is a std::span<Out> into a buffer that is reused from batch to batch.
+template <typename R, typename G>
+constexpr void for_each_batch(R& r, G g) {
+    using Out = std::ranges::range_value_t<R>;
+    // Not a std::vector, which would not be contiguous for bool.
+    auto buffer = std::make_unique<Out[]>(
+        (std::min)(std::size_t(std::ranges::size(r)), batch_size<Out>()));
+    detail::for_each_input_batch(r, [&](auto in, auto batch) {
+        std::span<Out> out(buffer.get(), in.size());
+        batch(in, out);
+        g(out);
+    });
+}
+
+struct chunk_probe {
+    template <typename Chunk>
+    constexpr void operator()(Chunk) const noexcept {}
+};
+
+// True iff V has a member for_each_chunk(max, g), which calls g with
+// consecutive sized contiguous ranges of at most max of V's elements, e.g.
+// a view with a sentinel that can be searched for more than one element at
+// a time.
+template <typename V>
+concept chunked_view = requires(const V& v) {
+    v.for_each_chunk(std::size_t(), chunk_probe{});
+};
+
+template <typename R,
+          bool = transform_view_traits<std::remove_cvref_t<R> >::
+              is_transform_view>
+inline constexpr bool is_chunked_range = chunked_view<std::remove_cvref_t<R> >;
+template <typename R>
+inline constexpr bool is_chunked_range<R, true> = chunked_view<
+    typename transform_view_traits<std::remove_cvref_t<R> >::base_type>;
+
+// True iff R is a chunked_view, or a transform_view over one.
+template <typename R>
+concept chunked_range = is_chunked_range<R>;
+
+// Calls g(chunk) for consecutive chunks of the elements of r, each a sized
+// view -- of r's base chunk, transformed by r's callable if r is a
+// transform_view -- of at most batch_size<range_value_t<R> >() elements.
+template <typename R, typename G>
+constexpr void for_each_chunk(R& r, G g) {
+    constexpr std::size_t size =
+        batch_size<std::ranges::range_value_t<R> >();
+    if constexpr (chunked_view<std::remove_cvref_t<R> >) {
+        r.for_each_chunk(size, g);
+    } else {
+        using F = typename transform_view_traits<
+            std::remove_cvref_t<R> >::func_type;
+        auto&& f = view_access::fun(r);
+        r.base().for_each_chunk(size, [&](auto chunk) {
+            if constexpr (tidy_func<F>)
+                g(transform_view(chunk, F()));
+            else
+                g(transform_view(chunk, std::ref(f)));
+        });
+    }
+}
+
+} // namespace detail
+
+/** Copies the elements of `r` to `out`, and returns the end of the output.
+    When `r` is a sized `transform_view` over a contiguous range, and its
+    callable is `batch_invocable`, the elements are computed `batch_bytes`
+    at a time by the callable's batch overload -- directly into the output if
+    `out` is contiguous, otherwise into a buffer that is then moved to `out`.
+    A `cstr_view` (or another view with a `for_each_chunk()` member), or a
+    `transform_view` over one, is copied a chunk of that size at a time, so
+    that the end of each chunk is found without checking every element
+    against the sentinel.  Otherwise, this is `std::ranges::copy()`. */
+template <std::ranges::input_range R, std::weakly_incrementable O>
+    requires std::indirectly_copyable<std::ranges::iterator_t<R>, O>
+constexpr O batch_copy(R&& r, O out) {
+    using Out = std::ranges::range_value_t<R>;
+    if constexpr (detail::chunked_range<R>) {
+        detail::for_each_chunk(r, [&](auto chunk) {
+            out = beman::transform_view::batch_copy(chunk, std::move(out));
+        });
+        return out;
+    } else if constexpr (detail::batch_view<R>) {
+        if constexpr (detail::contiguous_output<O, Out>) {
+            detail::for_each_input_batch(r, [&](auto in, auto batch) {
+                batch(in, std::span<Out>(std::to_address(out), in.size()));
+                out += std::iter_difference_t<O>(in.size());
+            });
+        } else {
+            detail::for_each_batch(r, [&](std::span<Out> values) {
+                out = std::ranges::move(values, std::move(out)).out;
+            });
+        }
+        return out;
+    } else {
+        return std::ranges::copy((R&&)r, std::move(out)).out;
+    }
+}
+
+/** Calls `g(x)` for each element `x` of `r`, in order, and returns `g`.
+    Batch-capable views (see `batch_copy()`) are evaluated a batch at a
+    time, and `g` receives each element as an rvalue; chunked views are
+    traversed a chunk at a time. */
+template <std::ranges::input_range R, typename G>
+    requires std::invocable<G&, std::ranges::range_reference_t<R> >
+constexpr G batch_for_each(R&& r, G g) {
+    using Out = std::ranges::range_value_t<R>;
+    if constexpr (detail::chunked_range<R>) {
+        detail::for_each_chunk(r, [&](auto chunk) {
+            beman::transform_view::batch_for_each(chunk, std::ref(g));
+        });
+    } else if constexpr (detail::batch_view<R> && std::invocable<G&, Out>) {
+        detail::for_each_batch(r, [&](std::span<Out> values) {
+            for (Out& x : values)
+                std::invoke(g, std::move(x));
+        });
+    } else {
+        for (auto&& x : r)
+            std::invoke(g, (decltype(x)&&)x);
+    }
+    return g;
+}
+
+/** Returns a `C` holding the elements of `r`.  If `C` is a contiguous
+    container that can be resized, e.g. `std::vector`, it is sized up front
+    and filled with `batch_copy()`; otherwise each element is inserted at
+    the end of `C` in turn, using `batch_for_each()`. */
+template <typename C, std::ranges::input_range R>
+    requires std::default_initializable<C>
+constexpr C batch_to(R&& r) {
+    C c;
+    if constexpr (std::ranges::sized_range<R> &&
+                  std::ranges::contiguous_range<C> &&
+                  requires { c.resize(std::ranges::size(r)); }) {
+        c.resize(std::size_t(std::ranges::size(r)));
+        beman::transform_view::batch_copy(r, std::ranges::begin(c));
+    } else {
+        beman::transform_view::batch_for_each(r, [&c](auto&& x) {
+            c.insert(c.end(), (decltype(x)&&)x);
+        });
+    }
+    return c;
+}
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_BATCH_HPP
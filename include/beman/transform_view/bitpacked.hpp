@@ -0,0 +1,375 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_BITPACKED_HPP
+#define BEMAN_TRANSFORM_VIEW_BITPACKED_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#endif
+
+// On x86 hosts with AVX2, blocks of values of up to 24 bits are unpacked 8 at
+// a time: a byte shuffle moves each value's bytes into a 32-bit lane, and a
+// variable shift and a mask extract it.  The AVX2 code carries its own target
+// attribute and is chosen at run time, so that it is the same whatever flags
+// a translation unit is compiled with.
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES() &&            \
+    (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define BEMAN_TRANSFORM_VIEW_BITPACKED_AVX2 1
+#define BEMAN_TRANSFORM_VIEW_BITPACKED_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#else
+#define BEMAN_TRANSFORM_VIEW_BITPACKED_AVX2 0
+#endif
+
+namespace beman::transform_view {
+
+/** The number of values a `bitpacked_view` unpacks at once; its bulk
+    traversal decodes whole blocks of this many values. */
+inline constexpr std::size_t bitpacked_block = 64;
+
+namespace detail {
+
+template <std::size_t K>
+using bitpacked_value_t =
+    std::conditional_t<K <= 32, std::uint32_t, std::uint64_t>;
+
+template <std::size_t K>
+inline constexpr std::uint64_t bitpacked_mask =
+    K == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << K) - 1;
+
+// Loads n <= 8 bytes from p as a little-endian integer.
+inline std::uint64_t load_le(const std::byte* p, std::size_t n) noexcept {
+    std::uint64_t w = 0;
+    std::memcpy(&w, p, n);
+    if constexpr (std::endian::native == std::endian::big)
+        w = std::byteswap(w);
+    return w;
+}
+
+// Returns value i of the packed values in [data, data + bytes).
+template <std::size_t K>
+bitpacked_value_t<K> bitpacked_get(const std::byte* data,
+                                   std::size_t      bytes,
+                                   std::size_t      i) noexcept {
+    const std::size_t bit   = i * K;
+    const std::size_t byte  = bit / 8;
+    const unsigned    shift = unsigned(bit % 8);
+    const std::size_t n     = (std::min)(bytes - byte, std::size_t(8));
+    std::uint64_t     v     = detail::load_le(data + byte, n) >> shift;
+    if constexpr (57 < K) {
+        if (64 < shift + K)
+            v |= std::uint64_t(data[byte + 8]) << (64 - shift);
+    }
+    return bitpacked_value_t<K>(v & bitpacked_mask<K>);
+}
+
+// Unpacks the bitpacked_block values in the K 64-bit words at in.  The
+// block is unrolled, so that every shift is a constant.
+template <std::size_t K>
+void unpack_block_scalar(const std::byte*      in,
+                         bitpacked_value_t<K>* out) noexcept {
+    std::array<std::uint64_t, K + 1> w;
+    for (std::size_t j = 0; j < K; ++j)
+        w[j] = detail::load_le(in + 8 * j, 8);
+    w[K] = 0;
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((out[I] = bitpacked_value_t<K>(
+              ((w[I * K / 64] >> (I * K % 64)) |
+               (I * K % 64 + K > 64
+                    ? w[I * K / 64 + 1] << ((64 - I * K % 64) % 64)
+                    : 0)) &
+              bitpacked_mask<K>)),
+         ...);
+    }(std::make_index_sequence<bitpacked_block>());
+}
+
+#if BEMAN_TRANSFORM_VIEW_BITPACKED_AVX2
+// Eight values of K bits take K bytes.  Values 0-3 are shuffled out of the 16
+// bytes at the start of the group, and values 4-7 out of the 16 bytes at
+// byte 4K / 8.
+template <std::size_t K>
+struct bitpacked_avx2_tables {
+    static constexpr std::size_t high = 4 * K / 8;
+
+    alignas(32) static constexpr std::array<std::int8_t, 32> shuffle = [] {
+        std::array<std::int8_t, 32> s{};
+        for (std::size_t j = 0; j < 8; ++j) {
+            const std::size_t start = j * K / 8 - (j < 4 ? 0 : high);
+            for (std::size_t b = 0; b < 4; ++b)
+                s[4 * j + b] = std::int8_t(start + b);
+        }
+        return s;
+    }();
+    alignas(32) static constexpr std::array<std::int32_t, 8> shifts = [] {
+        std::array<std::int32_t, 8> s{};
+        for (std::size_t j = 0; j < 8; ++j)
+            s[j] = std::int32_t(j * K % 8);
+        return s;
+    }();
+};
+
+// Unpacks a block as above, reading up to 16 bytes past its end.
+template <std::size_t K>
+    requires(K <= 24)
+BEMAN_TRANSFORM_VIEW_BITPACKED_TARGET("avx2")
+void unpack_block_avx2(const std::byte* in, std::uint32_t* out) noexcept {
+    using tables = bitpacked_avx2_tables<K>;
+    const __m256i shuf  = _mm256_load_si256(
+        reinterpret_cast<const __m256i*>(tables::shuffle.data()));
+    const __m256i shift = _mm256_load_si256(
+        reinterpret_cast<const __m256i*>(tables::shifts.data()));
+    const __m256i mask  = _mm256_set1_epi32(std::int32_t(bitpacked_mask<K>));
+    for (std::size_t g = 0; g < bitpacked_block / 8; ++g) {
+        const std::byte* p  = in + g * K;
+        const __m128i    lo = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(p));
+        const __m128i    hi = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(p + tables::high));
+        const __m256i bytes =
+            _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        const __m256i v = _mm256_and_si256(
+            _mm256_srlv_epi32(_mm256_shuffle_epi8(bytes, shuf), shift), mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 8 * g), v);
+    }
+}
+
+inline bool bitpacked_has_avx2() noexcept {
+    static const bool result = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return result;
+}
+#endif
+
+// Unpacks the block at in, of which at least avail bytes may be read.
+template <std::size_t K>
+void unpack_block(const std::byte*      in,
+                  std::size_t           avail,
+                  bitpacked_value_t<K>* out) noexcept {
+#if BEMAN_TRANSFORM_VIEW_BITPACKED_AVX2
+    if constexpr (K <= 24) {
+        if (8 * K + 16 <= avail && detail::bitpacked_has_avx2()) {
+            detail::unpack_block_avx2<K>(in, out);
+            return;
+        }
+    }
+#endif
+    (void)avail;
+    detail::unpack_block_scalar<K>(in, out);
+}
+
+} // namespace detail
+
+/** A random-access, sized, borrowed view of `n` unsigned integers of `K`
+    bits each, packed into bytes with no padding: value `i` is bits
+    `[i * K, (i + 1) * K)` of the bytes read as one little-endian number.
+    The elements are `std::uint32_t` for `K` up to 32, and `std::uint64_t`
+    above that.
+
+    Iterating element by element extracts each value on its own.  The view
+    also provides `for_each_chunk()` (see `cstr_view`), through which
+    `batch_copy()`, `batch_for_each()` and `reduce()`, over the view or over
+    a `transform_view` of it, unpack `bitpacked_block` values at a time into
+    a buffer -- on hosts with AVX2, eight at a time -- and then apply the
+    transform to the contiguous buffer, which compilers vectorize. */
+template <std::size_t K>
+    requires(0 < K && K <= 64)
+class bitpacked_view : public std::ranges::view_interface<bitpacked_view<K> > {
+  public:
+    using value_type = detail::bitpacked_value_t<K>;
+
+    /** The number of values `for_each_chunk()` unpacks into its buffer at
+        most at once. */
+    static constexpr std::size_t chunk_capacity = 8 * bitpacked_block;
+
+    class iterator {
+      public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = bitpacked_view::value_type;
+        using difference_type   = std::ptrdiff_t;
+
+        iterator() = default;
+
+        value_type operator*() const noexcept {
+            return detail::bitpacked_get<K>(data_, bytes_, std::size_t(i_));
+        }
+        value_type operator[](difference_type n) const noexcept {
+            return detail::bitpacked_get<K>(data_, bytes_, std::size_t(i_ + n));
+        }
+
+        iterator& operator++() noexcept {
+            ++i_;
+            return *this;
+        }
+        iterator operator++(int) noexcept {
+            auto tmp = *this;
+            ++i_;
+            return tmp;
+        }
+        iterator& operator--() noexcept {
+            --i_;
+            return *this;
+        }
+        iterator operator--(int) noexcept {
+            auto tmp = *this;
+            --i_;
+            return tmp;
+        }
+        iterator& operator+=(difference_type n) noexcept {
+            i_ += n;
+            return *this;
+        }
+        iterator& operator-=(difference_type n) noexcept {
+            i_ -= n;
+            return *this;
+        }
+
+        friend iterator operator+(iterator it, difference_type n) noexcept {
+            return it += n;
+        }
+        friend iterator operator+(difference_type n, iterator it) noexcept {
+            return it += n;
+        }
+        friend iterator operator-(iterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+        friend difference_type operator-(const iterator& x,
+                                         const iterator& y) noexcept {
+            return x.i_ - y.i_;
+        }
+
+        friend bool operator==(const iterator& x, const iterator& y) noexcept {
+            return x.i_ == y.i_;
+        }
+        friend std::strong_ordering operator<=>(const iterator& x,
+                                                const iterator& y) noexcept {
+            return x.i_ <=> y.i_;
+        }
+
+      private:
+        friend bitpacked_view;
+
+        iterator(const std::byte* data,
+                 std::size_t      bytes,
+                 difference_type  i) noexcept
+            : data_(data), bytes_(bytes), i_(i) {}
+
+        const std::byte* data_  = nullptr;
+        std::size_t      bytes_ = 0;
+        difference_type  i_     = 0;
+    };
+
+    bitpacked_view() = default;
+
+    /** Views the first `n` values packed in `bytes`, which must hold at
+        least `(n * K + 7) / 8` bytes. */
+    constexpr bitpacked_view(std::span<const std::byte> bytes,
+                             std::size_t                n) noexcept
+        : data_(bytes.data()), bytes_(bytes.size()), size_(n) {}
+
+    iterator begin() const noexcept { return iterator(data_, bytes_, 0); }
+    iterator end() const noexcept {
+        return iterator(data_, bytes_, std::ptrdiff_t(size_));
+    }
+
+    constexpr std::size_t size() const noexcept { return size_; }
+
+    /** Returns the packed bytes. */
+    constexpr std::span<const std::byte> bytes() const noexcept {
+        return {data_, bytes_};
+    }
+
+    /** Calls `g(chunk)` for consecutive `std::span<const value_type>`s
+        `chunk` of unpacked values, which together hold the values of
+        `*this`.  Each has `min(max, chunk_capacity)` values, rounded down to
+        a multiple of `bitpacked_block` if that is at least one block, except
+        for the last, which may have fewer. */
+    template <typename G>
+        requires std::invocable<G&, std::span<const value_type> >
+    void for_each_chunk(std::size_t max, G&& g) const {
+        std::size_t per = (std::min)(max, chunk_capacity);
+        if (bitpacked_block <= per)
+            per -= per % bitpacked_block;
+        else if (per == 0)
+            per = 1;
+        alignas(32) value_type buffer[chunk_capacity];
+        for (std::size_t i = 0; i < size_;) {
+            const std::size_t n = (std::min)(per, size_ - i);
+            std::size_t       j = 0;
+            if (i % bitpacked_block == 0) {
+                for (; j + bitpacked_block <= n; j += bitpacked_block) {
+                    const std::size_t byte = (i + j) / 8 * K;
+                    detail::unpack_block<K>(
+                        data_ + byte, bytes_ - byte, buffer + j);
+                }
+            }
+            for (; j < n; ++j)
+                buffer[j] = detail::bitpacked_get<K>(data_, bytes_, i + j);
+            g(std::span<const value_type>(buffer, n));
+            i += n;
+        }
+    }
+
+  private:
+    const std::byte* data_  = nullptr;
+    std::size_t      bytes_ = 0;
+    std::size_t      size_  = 0;
+};
+
+namespace views {
+
+namespace detail {
+
+template <std::size_t K>
+struct bitpacked_fn {
+    constexpr bitpacked_view<K> operator() [[nodiscard]] (
+        std::span<const std::byte> bytes, std::size_t n) const noexcept {
+        return bitpacked_view<K>(bytes, n);
+    }
+};
+
+} // namespace detail
+
+/** `views::bitpacked<K>(bytes, n)` returns a `bitpacked_view<K>` of the `n`
+    `K`-bit values packed in `bytes`. */
+template <std::size_t K>
+    requires(0 < K && K <= 64)
+inline constexpr detail::bitpacked_fn<K> bitpacked;
+
+} // namespace views
+
+} // namespace beman::transform_view
+
+template <std::size_t K>
+constexpr bool std::ranges::enable_borrowed_range<
+    beman::transform_view::bitpacked_view<K> > = true;
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_BITPACKED_HPP
@@ -10,4 +10,19 @@
 #define BEMAN_TRANSFORM_VIEW_USE_MODULES() 0
 #endif
 
+// When this is 1, transform_view.hpp does not include <functional> or
+// <optional> directly (other standard headers may); see
+// BEMAN_TRANSFORM_VIEW_LIGHTWEIGHT in CMakeLists.txt.
+#if !defined(BEMAN_TRANSFORM_VIEW_LIGHTWEIGHT)
+#define BEMAN_TRANSFORM_VIEW_LIGHTWEIGHT() 0
+#endif
+
+// MSVC accepts [[no_unique_address]] but ignores it, which leaves wrappers of
+// empty callables non-empty, and so not tidy.
+#if defined(_MSC_VER) && __has_cpp_attribute(msvc::no_unique_address)
+#define BEMAN_TRANSFORM_VIEW_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define BEMAN_TRANSFORM_VIEW_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
 #endif
@@ -0,0 +1,263 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_CSTR_HPP
+#define BEMAN_TRANSFORM_VIEW_CSTR_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#endif
+
+// The terminator is searched for 16 (SSE2) or 32 (AVX2) bytes at a time.
+// The loads are aligned, so they never cross into a page that the string
+// does not reach, but they do read past the terminator, so they are exempt
+// from AddressSanitizer.  The AVX2 scanner carries its own target attribute
+// and is chosen at run time, so that it is the same whatever flags a
+// translation unit is compiled with.
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64))
+#define BEMAN_TRANSFORM_VIEW_CSTR_SCAN 1
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define BEMAN_TRANSFORM_VIEW_NO_SANITIZE_ADDRESS \
+    __attribute__((no_sanitize_address))
+#else
+#define BEMAN_TRANSFORM_VIEW_NO_SANITIZE_ADDRESS
+#endif
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define BEMAN_TRANSFORM_VIEW_CSTR_AVX2 1
+#define BEMAN_TRANSFORM_VIEW_CSTR_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BEMAN_TRANSFORM_VIEW_CSTR_AVX2 0
+#endif
+#else
+#define BEMAN_TRANSFORM_VIEW_CSTR_SCAN 0
+#define BEMAN_TRANSFORM_VIEW_CSTR_AVX2 0
+#endif
+
+namespace beman::transform_view {
+
+namespace detail {
+
+template <typename T>
+concept cstr_char =
+    std::same_as<T, char> || std::same_as<T, signed char> ||
+    std::same_as<T, unsigned char> || std::same_as<T, wchar_t> ||
+    std::same_as<T, char8_t> || std::same_as<T, char16_t> ||
+    std::same_as<T, char32_t>;
+
+#if BEMAN_TRANSFORM_VIEW_CSTR_SCAN
+// Checks the characters of s one at a time up to a Width-byte boundary, and
+// returns the index of the first null among them, or of the first character
+// on the boundary, or max.  Misaligned wide characters never reach a
+// boundary, so all of them are checked.
+template <std::size_t Width, typename CharT>
+std::size_t scan_head(const CharT* s, std::size_t max) noexcept {
+    std::size_t i     = 0;
+    const auto  start = reinterpret_cast<std::uintptr_t>(s);
+    if (start % sizeof(CharT) != 0) {
+        for (; i < max && s[i] != CharT(); ++i) {
+        }
+        return i;
+    }
+    for (; i < max && (start + i * sizeof(CharT)) % Width != 0; ++i) {
+        if (s[i] == CharT())
+            return i;
+    }
+    return i;
+}
+
+// Returns the index of the null that the nonzero byte mask of the vector at
+// i reports, or max if it is past max.
+template <typename CharT>
+std::size_t
+scan_found(std::size_t i, std::uint32_t mask, std::size_t max) noexcept {
+    const std::size_t j =
+        i + std::size_t(std::countr_zero(mask)) / sizeof(CharT);
+    return j < max ? j : max;
+}
+
+// Each scan_terminator_* returns the number of characters before the first
+// null in s, or max if there is none among the first max.  Characters are
+// checked one at a time up to a vector boundary, then a whole aligned vector
+// at a time.  The two are spelled out separately because helpers shared
+// between them could not be inlined into both targets.
+template <typename CharT>
+BEMAN_TRANSFORM_VIEW_NO_SANITIZE_ADDRESS std::size_t
+scan_terminator_sse2(const CharT* s, std::size_t max) noexcept {
+    constexpr std::size_t per = 16 / sizeof(CharT);
+    std::size_t           i   = detail::scan_head<16>(s, max);
+    if (i == max || s[i] == CharT())
+        return i;
+    const __m128i z = _mm_setzero_si128();
+    for (; i < max; i += per) {
+        const __m128i v =
+            _mm_load_si128(reinterpret_cast<const __m128i*>(s + i));
+        std::uint32_t mask;
+        if constexpr (sizeof(CharT) == 1)
+            mask = std::uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, z)));
+        else if constexpr (sizeof(CharT) == 2)
+            mask = std::uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi16(v, z)));
+        else
+            mask = std::uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi32(v, z)));
+        if (mask != 0)
+            return detail::scan_found<CharT>(i, mask, max);
+    }
+    return max;
+}
+
+#if BEMAN_TRANSFORM_VIEW_CSTR_AVX2
+template <typename CharT>
+BEMAN_TRANSFORM_VIEW_CSTR_TARGET("avx2")
+BEMAN_TRANSFORM_VIEW_NO_SANITIZE_ADDRESS std::size_t
+scan_terminator_avx2(const CharT* s, std::size_t max) noexcept {
+    constexpr std::size_t per = 32 / sizeof(CharT);
+    std::size_t           i   = detail::scan_head<32>(s, max);
+    if (i == max || s[i] == CharT())
+        return i;
+    const __m256i z = _mm256_setzero_si256();
+    for (; i < max; i += per) {
+        const __m256i v =
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(s + i));
+        std::uint32_t mask;
+        if constexpr (sizeof(CharT) == 1)
+            mask = std::uint32_t(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, z)));
+        else if constexpr (sizeof(CharT) == 2)
+            mask = std::uint32_t(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi16(v, z)));
+        else
+            mask = std::uint32_t(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi32(v, z)));
+        if (mask != 0)
+            return detail::scan_found<CharT>(i, mask, max);
+    }
+    return max;
+}
+
+inline bool cstr_has_avx2() noexcept {
+    static const bool result = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return result;
+}
+#endif
+
+template <typename CharT>
+std::size_t scan_terminator(const CharT* s, std::size_t max) noexcept {
+#if BEMAN_TRANSFORM_VIEW_CSTR_AVX2
+    if (detail::cstr_has_avx2())
+        return detail::scan_terminator_avx2(s, max);
+#endif
+    return detail::scan_terminator_sse2(s, max);
+}
+#endif
+
+template <typename CharT>
+constexpr std::size_t find_terminator(const CharT* s, std::size_t max) {
+#if BEMAN_TRANSFORM_VIEW_CSTR_SCAN
+    if (!std::is_constant_evaluated())
+        return detail::scan_terminator(s, max);
+#endif
+    std::size_t i = 0;
+    for (; i < max && s[i] != CharT(); ++i) {
+    }
+    return i;
+}
+
+} // namespace detail
+
+/** The sentinel of a `cstr_view`: equal to a pointer to a null character. */
+struct cstr_sentinel {
+    template <detail::cstr_char CharT>
+    friend constexpr bool operator==(const CharT* p, cstr_sentinel) noexcept {
+        return *p == CharT();
+    }
+};
+
+/** A view of the characters of a null-terminated string, not including the
+    terminator.  Its iterators are `const CharT*`, and its sentinel is a
+    `cstr_sentinel`, so iterating it one element at a time checks each
+    character against the terminator.
+
+    It also provides `for_each_chunk()`, with which bulk algorithms (e.g.
+    `batch_copy()`, `batch_for_each()` and `reduce()`, over the view or over
+    a `transform_view` of it) look for the terminator a vector at a time
+    instead, and work on each chunk as a sized, contiguous range.  Each chunk
+    is searched just before it is used, while it is in cache. */
+template <detail::cstr_char CharT>
+class cstr_view : public std::ranges::view_interface<cstr_view<CharT> > {
+  public:
+    cstr_view() = default;
+    constexpr explicit cstr_view(const CharT* s) noexcept : s_(s) {}
+
+    constexpr const CharT*  begin() const noexcept { return s_; }
+    constexpr cstr_sentinel end() const noexcept { return {}; }
+
+    /** Calls `g(chunk)` for consecutive `std::span<const CharT>`s `chunk`
+        that together hold the characters of `*this`, each of `max`
+        characters except for the last, which may be empty. */
+    template <typename G>
+        requires std::invocable<G&, std::span<const CharT> >
+    constexpr void for_each_chunk(std::size_t max, G&& g) const {
+        const CharT* p = s_;
+        for (;;) {
+            const std::size_t n = detail::find_terminator(p, max);
+            g(std::span<const CharT>(p, n));
+            if (n < max)
+                return;
+            p += n;
+        }
+    }
+
+  private:
+    const CharT* s_ = nullptr;
+};
+
+namespace views {
+
+namespace detail {
+
+struct cstr_fn {
+    template <beman::transform_view::detail::cstr_char CharT>
+    constexpr cstr_view<CharT> operator() [[nodiscard]] (const CharT* s) const
+        noexcept {
+        return cstr_view<CharT>(s);
+    }
+};
+
+} // namespace detail
+
+/** Returns a `cstr_view` of the null-terminated string `s`. */
+inline constexpr detail::cstr_fn cstr;
+
+} // namespace views
+
+} // namespace beman::transform_view
+
+template <typename CharT>
+constexpr bool std::ranges::enable_borrowed_range<
+    beman::transform_view::cstr_view<CharT> > = true;
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_CSTR_HPP
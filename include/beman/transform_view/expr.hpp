@@ -0,0 +1,429 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_EXPR_HPP
+#define BEMAN_TRANSFORM_VIEW_EXPR_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#endif
+
+namespace beman::transform_view {
+
+namespace detail {
+
+// A scalar operand of an expression, e.g. the 2 in 2 * x.  It stands in for
+// a range whose elements all equal value, and indexes like one.
+template <typename T>
+struct expr_scalar {
+    T value;
+
+    constexpr const T& operator[](std::ptrdiff_t) const noexcept {
+        return value;
+    }
+};
+
+template <typename T>
+constexpr bool is_expr_scalar = false;
+template <typename T>
+constexpr bool is_expr_scalar<expr_scalar<T> > = true;
+
+template <typename L>
+concept expr_range = std::ranges::view<L> &&
+                     std::ranges::random_access_range<const L> &&
+                     std::ranges::sized_range<const L>;
+
+// The cursor of a leaf is what the expression indexes to get the leaf's
+// elements: a pointer for a contiguous range, an iterator for any other
+// range, and the leaf itself for a scalar.
+template <typename L>
+constexpr auto expr_cursor(const L& leaf) {
+    if constexpr (is_expr_scalar<L>)
+        return leaf;
+    else if constexpr (std::ranges::contiguous_range<const L>)
+        return std::ranges::data(leaf);
+    else
+        return std::ranges::begin(leaf);
+}
+
+template <typename L>
+using expr_cursor_t = decltype(detail::expr_cursor(std::declval<const L&>()));
+
+template <typename L>
+using expr_reference_t =
+    decltype(std::declval<const expr_cursor_t<L>&>()[std::ptrdiff_t()]);
+
+// The leaves of an expression, traversed in lockstep.  Its elements are
+// tuples of references to the leaves' elements at each index; the value
+// type is the same tuple, so that the iterator is indirectly readable
+// without tuple's common_reference support.  The size is that of the
+// shortest range leaf (and unbounded, for a lone scalar operand before it
+// is combined with anything).
+template <typename... Leaves>
+    requires((is_expr_scalar<Leaves> || expr_range<Leaves>) && ...)
+class expr_leaves
+    : public std::ranges::view_interface<expr_leaves<Leaves...> > {
+  public:
+    class iterator {
+      public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = std::tuple<expr_reference_t<Leaves>...>;
+        using difference_type   = std::ptrdiff_t;
+
+        iterator() = default;
+        constexpr iterator(std::tuple<expr_cursor_t<Leaves>...> cursors,
+                           difference_type                      n)
+            : cursors_(std::move(cursors)), n_(n) {}
+
+        constexpr value_type operator*() const { return (*this)[0]; }
+        constexpr value_type operator[](difference_type n) const {
+            return std::apply(
+                [i = n_ + n](const auto&... c) { return value_type(c[i]...); },
+                cursors_);
+        }
+
+        constexpr iterator& operator++() {
+            ++n_;
+            return *this;
+        }
+        constexpr iterator operator++(int) {
+            auto tmp = *this;
+            ++n_;
+            return tmp;
+        }
+        constexpr iterator& operator--() {
+            --n_;
+            return *this;
+        }
+        constexpr iterator operator--(int) {
+            auto tmp = *this;
+            --n_;
+            return tmp;
+        }
+        constexpr iterator& operator+=(difference_type n) {
+            n_ += n;
+            return *this;
+        }
+        constexpr iterator& operator-=(difference_type n) {
+            n_ -= n;
+            return *this;
+        }
+
+        friend constexpr iterator operator+(iterator it, difference_type n) {
+            return it += n;
+        }
+        friend constexpr iterator operator+(difference_type n, iterator it) {
+            return it += n;
+        }
+        friend constexpr iterator operator-(iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend constexpr difference_type operator-(const iterator& x,
+                                                   const iterator& y) {
+            return x.n_ - y.n_;
+        }
+        friend constexpr bool operator==(const iterator& x, const iterator& y) {
+            return x.n_ == y.n_;
+        }
+        friend constexpr std::strong_ordering operator<=>(const iterator& x,
+                                                          const iterator& y) {
+            return x.n_ <=> y.n_;
+        }
+
+      private:
+        std::tuple<expr_cursor_t<Leaves>...> cursors_{};
+        difference_type                      n_ = 0;
+    };
+
+    expr_leaves() = default;
+    constexpr explicit expr_leaves(std::tuple<Leaves...> leaves)
+        : leaves_(std::move(leaves)) {}
+
+    constexpr const std::tuple<Leaves...>& leaves() const& noexcept {
+        return leaves_;
+    }
+    constexpr std::tuple<Leaves...> leaves() && { return std::move(leaves_); }
+
+    constexpr std::tuple<expr_cursor_t<Leaves>...> cursors() const {
+        return std::apply(
+            [](const auto&... leaf) {
+                return std::tuple<expr_cursor_t<Leaves>...>(
+                    detail::expr_cursor(leaf)...);
+            },
+            leaves_);
+    }
+
+    constexpr iterator begin() const { return iterator(cursors(), 0); }
+    constexpr iterator end() const {
+        return iterator(cursors(), std::ptrdiff_t(size()));
+    }
+
+    constexpr std::size_t size() const {
+        std::size_t n = std::size_t(-1);
+        std::apply(
+            [&n](const auto&... leaf) {
+                ((n = (std::min)(n, leaf_size(leaf))), ...);
+            },
+            leaves_);
+        return n;
+    }
+
+  private:
+    template <typename L>
+    static constexpr std::size_t leaf_size(const L& leaf) {
+        if constexpr (is_expr_scalar<L>)
+            return std::size_t(-1);
+        else
+            return std::size_t(std::ranges::size(leaf));
+    }
+
+    std::tuple<Leaves...> leaves_;
+};
+
+// The nodes of an expression tree are empty callables that take one
+// argument per leaf: expr_leaf<I> returns the I-th one, and expr_op<Op, Ns...>
+// applies Op to the results of its children.
+template <std::size_t I>
+struct expr_leaf {
+    template <typename... Xs>
+    constexpr auto&& operator()(Xs&&... xs) const {
+        return std::get<I>(std::forward_as_tuple((Xs&&)xs...));
+    }
+};
+
+template <typename Op, typename... Ns>
+struct expr_op {
+    template <typename... Xs>
+    constexpr decltype(auto) operator()(Xs&&... xs) const {
+        return Op()(Ns()(xs...)...);
+    }
+};
+
+// Renumbers the leaves of N to start at K, for when the leaves of the
+// expression N belongs to follow K others.
+template <std::size_t K, typename N>
+struct expr_rebase;
+template <std::size_t K, std::size_t I>
+struct expr_rebase<K, expr_leaf<I> > {
+    using type = expr_leaf<K + I>;
+};
+template <std::size_t K, typename Op, typename... Ns>
+struct expr_rebase<K, expr_op<Op, Ns...> > {
+    using type = expr_op<Op, typename expr_rebase<K, Ns>::type...>;
+};
+
+// The result of evaluating Node on elements of types Refs.  An expression
+// that is a single leaf has that leaf's reference type, so that it does not
+// refer into the tuple of elements it was evaluated from.
+template <typename Node, typename... Refs>
+struct expr_result {
+    using type = decltype(Node()(std::declval<Refs&>()...));
+};
+template <std::size_t I, typename... Refs>
+struct expr_result<expr_leaf<I>, Refs...> {
+    using type = std::tuple_element_t<I, std::tuple<Refs...> >;
+};
+
+// The callable of an expression's transform_view: evaluates the tree Node on
+// the leaves' elements at one index.
+template <typename Node>
+struct expr_call {
+    template <typename... Refs>
+    constexpr typename expr_result<Node, Refs...>::type
+    operator()(const std::tuple<Refs...>& t) const {
+        return std::apply(Node(), t);
+    }
+};
+
+template <typename E>
+struct expr_traits {
+    static constexpr bool is_expr = false;
+};
+template <typename Node, typename... Leaves>
+struct expr_traits<
+    beman::transform_view::transform_view<expr_leaves<Leaves...>,
+                                          expr_call<Node> > > {
+    static constexpr bool is_expr = true;
+    using node_type               = Node;
+    using leaves_type             = std::tuple<Leaves...>;
+};
+
+template <typename T>
+concept expr_type = expr_traits<std::remove_cvref_t<T> >::is_expr;
+
+template <typename T>
+concept expr_operand =
+    expr_type<T> || std::is_arithmetic_v<std::remove_cvref_t<T> >;
+
+template <typename Node, typename... Leaves>
+constexpr auto make_expr(std::tuple<Leaves...> leaves) {
+    return beman::transform_view::transform_view(
+        expr_leaves<Leaves...>(std::move(leaves)), expr_call<Node>());
+}
+
+// Returns operand as an expression; a scalar becomes a one-leaf expression.
+template <typename T>
+constexpr auto to_expr(T&& operand) {
+    if constexpr (expr_type<T>) {
+        return std::remove_cvref_t<T>((T&&)operand);
+    } else {
+        using scalar = expr_scalar<std::remove_cvref_t<T> >;
+        return detail::make_expr<expr_leaf<0> >(
+            std::tuple<scalar>(scalar{(T&&)operand}));
+    }
+}
+
+template <typename E>
+constexpr auto expr_leaves_of(E&& e) {
+    return ((E&&)e).base().leaves();
+}
+
+template <typename Op, typename L, typename R>
+constexpr auto combine(L&& l, R&& r) {
+    auto lhs = detail::to_expr((L&&)l);
+    auto rhs = detail::to_expr((R&&)r);
+    using left_traits  = expr_traits<decltype(lhs)>;
+    using right_traits = expr_traits<decltype(rhs)>;
+    using node         = expr_op<
+        Op,
+        typename left_traits::node_type,
+        typename expr_rebase<
+            std::tuple_size_v<typename left_traits::leaves_type>,
+            typename right_traits::node_type>::type>;
+    return detail::make_expr<node>(
+        std::tuple_cat(std::move(lhs).base().leaves(),
+                       std::move(rhs).base().leaves()));
+}
+
+template <typename Op, typename E>
+constexpr auto apply_unary(E&& e) {
+    using traits = expr_traits<std::remove_cvref_t<E> >;
+    return detail::make_expr<expr_op<Op, typename traits::node_type> >(
+        detail::expr_leaves_of((E&&)e));
+}
+
+struct as_expr_fn {
+    template <std::ranges::viewable_range R>
+        requires expr_range<std::views::all_t<R> >
+    constexpr auto operator()(R&& r) const {
+        using leaf = std::views::all_t<R>;
+        return detail::make_expr<expr_leaf<0> >(
+            std::tuple<leaf>(std::views::all((R&&)r)));
+    }
+};
+
+} // namespace detail
+
+/** The type of an elementwise expression over the leaves `Leaves`, whose
+    element at each index is the tree of operations `Node` applied to the
+    leaves' elements at that index.  It is a `transform_view` with a tidy
+    callable over the leaves in lockstep, so it is a borrowed range when all
+    of its range leaves are.  Expressions are made with `as_expr()` and the
+    arithmetic operators below, not named directly. */
+template <typename Node, typename... Leaves>
+using expr = transform_view<detail::expr_leaves<Leaves...>,
+                            detail::expr_call<Node> >;
+
+/** Returns an expression whose elements are those of `r`, a sized
+    random-access range that can be iterated when `const`.  Combining
+    expressions with each other, or with arithmetic scalars, using `+`, `-`,
+    `*`, `/` or unary `-`, yields a single expression over all of their
+    leaves; e.g. `as_expr(a) + as_expr(b) * 2` is one view, of the same
+    size as the shorter of `a` and `b`, with no intermediate views or
+    temporaries. */
+inline constexpr detail::as_expr_fn as_expr;
+
+template <typename L, typename R>
+    requires(detail::expr_type<L> || detail::expr_type<R>) &&
+            detail::expr_operand<L> && detail::expr_operand<R>
+constexpr auto operator+(L&& l, R&& r) {
+    return detail::combine<std::plus<> >((L&&)l, (R&&)r);
+}
+
+template <typename L, typename R>
+    requires(detail::expr_type<L> || detail::expr_type<R>) &&
+            detail::expr_operand<L> && detail::expr_operand<R>
+constexpr auto operator-(L&& l, R&& r) {
+    return detail::combine<std::minus<> >((L&&)l, (R&&)r);
+}
+
+template <typename L, typename R>
+    requires(detail::expr_type<L> || detail::expr_type<R>) &&
+            detail::expr_operand<L> && detail::expr_operand<R>
+constexpr auto operator*(L&& l, R&& r) {
+    return detail::combine<std::multiplies<> >((L&&)l, (R&&)r);
+}
+
+template <typename L, typename R>
+    requires(detail::expr_type<L> || detail::expr_type<R>) &&
+            detail::expr_operand<L> && detail::expr_operand<R>
+constexpr auto operator/(L&& l, R&& r) {
+    return detail::combine<std::divides<> >((L&&)l, (R&&)r);
+}
+
+template <detail::expr_type E>
+constexpr auto operator-(E&& e) {
+    return detail::apply_unary<std::negate<> >((E&&)e);
+}
+
+/** Writes the elements of the expression `e` to `out`, and returns the end
+    of the output.  This is one loop over an index, in which each leaf is
+    read through a pointer (for contiguous ranges), an iterator, or a
+    scalar, and `e`'s whole tree of operations is inlined; when `out` is
+    contiguous too, the compiler can vectorize it. */
+template <typename Node, typename... Leaves, std::weakly_incrementable O>
+    requires std::indirectly_writable<
+        O,
+        std::ranges::range_reference_t<const expr<Node, Leaves...> > >
+constexpr O evaluate(const expr<Node, Leaves...>& e, O out) {
+    const auto leaves = e.base();
+    const auto n      = std::ptrdiff_t(leaves.size());
+    std::apply(
+        [&](const auto&... c) {
+            if constexpr (std::contiguous_iterator<O>) {
+                auto* p = std::to_address(out);
+                for (std::ptrdiff_t i = 0; i < n; ++i)
+                    p[i] = Node()(c[i]...);
+                out += std::iter_difference_t<O>(n);
+            } else {
+                for (std::ptrdiff_t i = 0; i < n; ++i, ++out)
+                    *out = Node()(c[i]...);
+            }
+        },
+        leaves.cursors());
+    return out;
+}
+
+} // namespace beman::transform_view
+
+template <typename... Leaves>
+constexpr bool std::ranges::enable_borrowed_range<
+    beman::transform_view::detail::expr_leaves<Leaves...> > =
+    ((beman::transform_view::detail::is_expr_scalar<Leaves> ||
+      std::ranges::enable_borrowed_range<Leaves>) &&
+     ...);
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_EXPR_HPP
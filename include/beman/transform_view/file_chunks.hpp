@@ -0,0 +1,693 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_FILE_CHUNKS_HPP
+#define BEMAN_TRANSFORM_VIEW_FILE_CHUNKS_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <vector>
+#endif
+
+// Files are read with pread() where POSIX is available, and otherwise (and
+// in the modules build) through a std::ifstream shared by the reading
+// threads.  On Linux, reads are submitted through io_uring when the kernel
+// allows it; the raw system calls are used, so there is nothing to link.
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES() && __has_include(<unistd.h>) && \
+    __has_include(<fcntl.h>) && __has_include(<sys/stat.h>)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BEMAN_TRANSFORM_VIEW_POSIX_FILES 1
+#else
+#define BEMAN_TRANSFORM_VIEW_POSIX_FILES 0
+#endif
+
+#if BEMAN_TRANSFORM_VIEW_POSIX_FILES && defined(__linux__) && \
+    __has_include(<linux/io_uring.h>) && __has_include(<sys/mman.h>) && \
+    __has_include(<sys/syscall.h>) && __has_include(<sys/uio.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#define BEMAN_TRANSFORM_VIEW_IO_URING 1
+#else
+#define BEMAN_TRANSFORM_VIEW_IO_URING 0
+#endif
+
+namespace beman::transform_view {
+
+/** Selects how `views::file_chunks` reads. */
+enum class file_io {
+    automatic, ///< io_uring where the kernel allows it, otherwise `threads`
+    threads    ///< blocking reads on a pool of threads
+};
+
+namespace detail {
+
+#if BEMAN_TRANSFORM_VIEW_POSIX_FILES
+class file_handle {
+  public:
+    explicit file_handle(const std::filesystem::path& path)
+        : fd_(::open(path.c_str(), O_RDONLY | O_CLOEXEC)) {
+        if (fd_ < 0)
+            throw std::system_error(
+                errno, std::generic_category(), path.string());
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+            const int error = errno;
+            ::close(fd_);
+            throw std::system_error(
+                error, std::generic_category(), path.string());
+        }
+        size_ = std::uint64_t(st.st_size);
+#if defined(POSIX_FADV_SEQUENTIAL)
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL); // Only a hint.
+#endif
+    }
+
+    file_handle(const file_handle&)            = delete;
+    file_handle& operator=(const file_handle&) = delete;
+
+    ~file_handle() { ::close(fd_); }
+
+    int           native() const noexcept { return fd_; }
+    std::uint64_t size() const noexcept { return size_; }
+
+    // Reads n bytes at offset into p, or fewer at the end of the file, and
+    // returns how many were read.
+    std::size_t
+    read_at(std::byte* p, std::size_t n, std::uint64_t offset) const {
+        std::size_t done = 0;
+        while (done < n) {
+            const ::ssize_t r =
+                ::pread(fd_, p + done, n - done, ::off_t(offset + done));
+            if (r < 0 && errno == EINTR)
+                continue;
+            if (r < 0)
+                throw std::system_error(
+                    errno, std::generic_category(), "pread");
+            if (r == 0)
+                break;
+            done += std::size_t(r);
+        }
+        return done;
+    }
+
+  private:
+    int           fd_;
+    std::uint64_t size_ = 0;
+};
+#else
+class file_handle {
+  public:
+    explicit file_handle(const std::filesystem::path& path)
+        : in_(path, std::ios::binary), size_(std::filesystem::file_size(path)) {
+        if (!in_)
+            throw std::system_error(
+                std::make_error_code(std::errc::io_error), path.string());
+    }
+
+    std::uint64_t size() const noexcept { return size_; }
+
+    std::size_t
+    read_at(std::byte* p, std::size_t n, std::uint64_t offset) const {
+        std::lock_guard lock(mutex_);
+        in_.clear();
+        in_.seekg(std::streamoff(offset));
+        in_.read(reinterpret_cast<char*>(p), std::streamsize(n));
+        if (in_.bad())
+            throw std::system_error(
+                std::make_error_code(std::errc::io_error), "read");
+        return std::size_t(in_.gcount());
+    }
+
+  private:
+    mutable std::mutex    mutex_;
+    mutable std::ifstream in_;
+    std::uint64_t         size_;
+};
+#endif
+
+// Reads into numbered slots asynchronously; at most one read per slot is
+// outstanding at a time.
+class chunk_reader {
+  public:
+    virtual ~chunk_reader() = default;
+
+    // Starts reading size bytes at offset into data, as the read of slot.
+    virtual void submit(std::size_t   slot,
+                        std::byte*    data,
+                        std::size_t   size,
+                        std::uint64_t offset) = 0;
+
+    // Waits for the read of slot, and returns the number of bytes read,
+    // which is less than requested only at the end of the file.
+    virtual std::size_t wait(std::size_t slot) = 0;
+
+    // Waits for every read still outstanding.  Returns false if that cannot
+    // be done; the reads' buffers, and the reader, must then never be freed.
+    virtual bool finish() noexcept { return true; }
+};
+
+// Reads with blocking calls on a thread per slot but one.  Queued reads
+// are dropped on destruction; reads in progress are waited for.
+class thread_chunk_reader final : public chunk_reader {
+  public:
+    thread_chunk_reader(const file_handle& file, std::size_t slots)
+        : file_(file), slots_(slots) {
+        try {
+            for (std::size_t i = 1; i < slots; ++i)
+                threads_.emplace_back([this] { work(); });
+        } catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    ~thread_chunk_reader() override { stop(); }
+
+    void submit(std::size_t   slot,
+                std::byte*    data,
+                std::size_t   size,
+                std::uint64_t offset) override {
+        {
+            std::lock_guard lock(mutex_);
+            request& r = slots_[slot];
+            r.data     = data;
+            r.size     = size;
+            r.offset   = offset;
+            queue_.push_back(slot);
+        }
+        queued_.notify_one();
+    }
+
+    std::size_t wait(std::size_t slot) override {
+        std::unique_lock lock(mutex_);
+        request& r = slots_[slot];
+        done_.wait(lock, [&r] { return r.done; });
+        r.done = false;
+        if (r.error)
+            std::rethrow_exception(std::exchange(r.error, nullptr));
+        return r.bytes;
+    }
+
+  private:
+    struct request {
+        std::byte*         data   = nullptr;
+        std::size_t        size   = 0;
+        std::uint64_t      offset = 0;
+        std::size_t        bytes  = 0;
+        std::exception_ptr error;
+        bool               done = false;
+    };
+
+    void work() {
+        std::unique_lock lock(mutex_);
+        for (;;) {
+            queued_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (stop_)
+                return;
+            request& r = slots_[queue_.front()];
+            queue_.pop_front();
+            lock.unlock();
+
+            std::size_t        bytes = 0;
+            std::exception_ptr error;
+            try {
+                bytes = file_.read_at(r.data, r.size, r.offset);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            lock.lock();
+            r.bytes = bytes;
+            r.error = std::move(error);
+            r.done  = true;
+            done_.notify_all();
+        }
+    }
+
+    void stop() noexcept {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        queued_.notify_all();
+        for (std::thread& t : threads_)
+            t.join();
+    }
+
+    const file_handle&       file_;
+    std::vector<request>     slots_;
+    std::deque<std::size_t>  queue_;
+    std::mutex               mutex_;
+    std::condition_variable  queued_;
+    std::condition_variable  done_;
+    bool                     stop_ = false;
+    std::vector<std::thread> threads_;
+};
+
+#if BEMAN_TRANSFORM_VIEW_IO_URING
+// Submits reads to an io_uring instance of its own.  All reads are waited
+// for by finish(), and on destruction, since the kernel writes into the
+// slots' buffers.
+class uring_chunk_reader final : public chunk_reader {
+  public:
+    // Returns nullptr if the kernel does not allow io_uring, e.g. because
+    // it is too old or a seccomp filter forbids it.
+    static std::unique_ptr<chunk_reader> create(const file_handle& file,
+                                                std::size_t        slots) {
+        std::unique_ptr<uring_chunk_reader> reader(
+            new uring_chunk_reader(file, slots));
+        if (!reader->setup(unsigned(std::bit_ceil(slots))))
+            return nullptr;
+        return reader;
+    }
+
+    ~uring_chunk_reader() override {
+        finish();
+        if (sqes_ != nullptr)
+            ::munmap(sqes_, sqes_size_);
+        if (cq_ring_ != nullptr && cq_ring_ != sq_ring_)
+            ::munmap(cq_ring_, cq_ring_size_);
+        if (sq_ring_ != nullptr)
+            ::munmap(sq_ring_, sq_ring_size_);
+        if (ring_fd_ >= 0)
+            ::close(ring_fd_);
+    }
+
+    void submit(std::size_t   slot,
+                std::byte*    data,
+                std::size_t   size,
+                std::uint64_t offset) override {
+        request& r = slots_[slot];
+        r.iov      = {data, size};
+        r.offset   = offset;
+        r.done     = false;
+
+        const unsigned tail  = *sq_tail_;
+        const unsigned index = tail & *sq_mask_;
+        io_uring_sqe&  sqe   = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode    = IORING_OP_READV;
+        sqe.fd        = file_.native();
+        sqe.addr      = std::uint64_t(reinterpret_cast<std::uintptr_t>(&r.iov));
+        sqe.len       = 1;
+        sqe.off       = offset;
+        sqe.user_data = slot;
+        sq_array_[index] = index;
+        std::atomic_ref<unsigned>(*sq_tail_).store(
+            tail + 1, std::memory_order_release);
+        ++in_flight_;
+        if (enter(1, 0, 0) < 0)
+            throw std::system_error(
+                errno, std::generic_category(), "io_uring_enter");
+    }
+
+    std::size_t wait(std::size_t slot) override {
+        request& r = slots_[slot];
+        for (reap(); !r.done; reap()) {
+            if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0)
+                throw std::system_error(
+                    errno, std::generic_category(), "io_uring_enter");
+        }
+        r.done = false;
+        if (r.result < 0)
+            throw std::system_error(-r.result, std::generic_category(), "read");
+        // A short read before the end of the file is finished synchronously.
+        auto* const       data  = static_cast<std::byte*>(r.iov.iov_base);
+        const std::size_t bytes = std::size_t(r.result);
+        if (bytes == 0 || bytes == r.iov.iov_len)
+            return bytes;
+        return bytes + file_.read_at(data + bytes,
+                                     r.iov.iov_len - bytes,
+                                     r.offset + bytes);
+    }
+
+    // Keeps waiting through transient failures (EINTR, EAGAIN, and EBUSY
+    // while the completion queue is full), and gives up only on errors that
+    // mean the ring itself is unusable.
+    bool finish() noexcept override {
+        while (in_flight_ != 0) {
+            const unsigned unsubmitted =
+                *sq_tail_ -
+                std::atomic_ref<unsigned>(*sq_head_).load(
+                    std::memory_order_acquire);
+            if (enter(unsubmitted, 1, IORING_ENTER_GETEVENTS) < 0) {
+                if (errno != EAGAIN && errno != EBUSY)
+                    return false;
+                std::this_thread::yield();
+            }
+            reap();
+        }
+        return true;
+    }
+
+  private:
+    struct request {
+        ::iovec       iov{};
+        std::uint64_t offset = 0;
+        int           result = 0;
+        bool          done   = false;
+    };
+
+    uring_chunk_reader(const file_handle& file, std::size_t slots)
+        : file_(file), slots_(slots) {}
+
+    bool setup(unsigned entries) noexcept {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd_ = int(::syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd_ < 0)
+            return false;
+
+        sq_ring_size_ =
+            params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ =
+            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single)
+            sq_ring_size_ = cq_ring_size_ =
+                (std::max)(sq_ring_size_, cq_ring_size_);
+
+        sq_ring_ = map(sq_ring_size_, IORING_OFF_SQ_RING);
+        if (sq_ring_ == nullptr)
+            return false;
+        cq_ring_ = single ? sq_ring_ : map(cq_ring_size_, IORING_OFF_CQ_RING);
+        if (cq_ring_ == nullptr)
+            return false;
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_size_, IORING_OFF_SQES));
+        if (sqes_ == nullptr)
+            return false;
+
+        auto* const sq = static_cast<unsigned char*>(sq_ring_);
+        auto* const cq = static_cast<unsigned char*>(cq_ring_);
+        sq_head_  = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_  = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_  = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head_  = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_  = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_  = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_     = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    void* map(std::size_t size, std::uint64_t offset) noexcept {
+        void* p = ::mmap(nullptr,
+                         size,
+                         PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE,
+                         ring_fd_,
+                         ::off_t(offset));
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    long enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+        long r;
+        do {
+            r = ::syscall(__NR_io_uring_enter,
+                          ring_fd_,
+                          to_submit,
+                          min_complete,
+                          flags,
+                          nullptr,
+                          0);
+        } while (r < 0 && errno == EINTR);
+        return r;
+    }
+
+    // Records the completions the kernel has posted.
+    void reap() noexcept {
+        unsigned       head = *cq_head_;
+        const unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(
+            std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+            request&            r   = slots_[std::size_t(cqe.user_data)];
+            r.result                = cqe.res;
+            r.done                  = true;
+            --in_flight_;
+        }
+        std::atomic_ref<unsigned>(*cq_head_).store(head,
+                                                   std::memory_order_release);
+    }
+
+    const file_handle&   file_;
+    std::vector<request> slots_;
+    std::size_t          in_flight_ = 0;
+
+    int           ring_fd_      = -1;
+    void*         sq_ring_      = nullptr;
+    void*         cq_ring_      = nullptr;
+    io_uring_sqe* sqes_         = nullptr;
+    std::size_t   sq_ring_size_ = 0;
+    std::size_t   cq_ring_size_ = 0;
+    std::size_t   sqes_size_    = 0;
+    unsigned*     sq_head_      = nullptr;
+    unsigned*     sq_tail_      = nullptr;
+    unsigned*     sq_mask_      = nullptr;
+    unsigned*     sq_array_     = nullptr;
+    unsigned*     cq_head_      = nullptr;
+    unsigned*     cq_tail_      = nullptr;
+    unsigned*     cq_mask_      = nullptr;
+    io_uring_cqe* cqes_         = nullptr;
+};
+#endif
+
+// The state of a file_chunks_view: chunk k is read into slot k % slots_,
+// and chunk k + slots_ is submitted into that slot once the consumer moves
+// past chunk k.
+class file_chunks_state {
+  public:
+    file_chunks_state(const std::filesystem::path& path,
+                      std::size_t                  chunk_size,
+                      std::size_t                  depth,
+                      file_io                      io)
+        : file_(path),
+          chunk_size_((std::max)(chunk_size, std::size_t(1))),
+          slots_((std::max)(depth, std::size_t(1)) + 1),
+          count_((file_.size() + chunk_size_ - 1) / chunk_size_),
+          buffers_(std::make_unique_for_overwrite<std::byte[]>(
+              chunk_size_ * slots_)),
+          reader_(make_reader(io)) {}
+
+    // If the reads in flight cannot be waited for, the kernel may still
+    // write into the buffers, so they are leaked, along with the reader
+    // whose requests point into them.
+    ~file_chunks_state() {
+        if (!reader_->finish()) {
+            (void)reader_.release();
+            (void)buffers_.release();
+        }
+    }
+
+    void start() {
+        for (; next_ < count_ && next_ < slots_; ++next_)
+            submit(next_);
+        fetch();
+    }
+
+    void advance() {
+        if (next_ < count_)
+            submit(next_++);
+        ++current_;
+        fetch();
+    }
+
+    bool done() const noexcept { return current_ >= count_; }
+
+    std::span<const std::byte> current() const noexcept {
+        return {buffer(current_), bytes_};
+    }
+
+    std::uint64_t file_size() const noexcept { return file_.size(); }
+    bool uses_io_uring() const noexcept { return uses_io_uring_; }
+
+  private:
+    std::unique_ptr<chunk_reader> make_reader(file_io io) {
+#if BEMAN_TRANSFORM_VIEW_IO_URING
+        if (io == file_io::automatic) {
+            if (auto reader = uring_chunk_reader::create(file_, slots_)) {
+                uses_io_uring_ = true;
+                return reader;
+            }
+        }
+#else
+        (void)io;
+#endif
+        return std::make_unique<thread_chunk_reader>(file_, slots_);
+    }
+
+    std::byte* buffer(std::uint64_t chunk) const noexcept {
+        return buffers_.get() + std::size_t(chunk % slots_) * chunk_size_;
+    }
+
+    std::size_t expected(std::uint64_t chunk) const noexcept {
+        return std::size_t((std::min)(std::uint64_t(chunk_size_),
+                                      file_.size() - chunk * chunk_size_));
+    }
+
+    void submit(std::uint64_t chunk) {
+        reader_->submit(std::size_t(chunk % slots_),
+                        buffer(chunk),
+                        expected(chunk),
+                        chunk * chunk_size_);
+    }
+
+    // Waits for the current chunk.  If the file has shrunk, the stream ends
+    // early.
+    void fetch() {
+        if (done())
+            return;
+        bytes_ = reader_->wait(std::size_t(current_ % slots_));
+        if (bytes_ < expected(current_))
+            count_ = bytes_ == 0 ? current_ : current_ + 1;
+    }
+
+    // The reader is declared last, so that it is destroyed, and the threads
+    // of a thread_chunk_reader joined, before the buffers and the file.
+    file_handle                  file_;
+    std::size_t                  chunk_size_;
+    std::size_t                  slots_;
+    std::uint64_t                count_;
+    std::unique_ptr<std::byte[]> buffers_;
+    std::uint64_t                next_          = 0;
+    std::uint64_t                current_       = 0;
+    std::size_t                  bytes_         = 0;
+    bool                         uses_io_uring_ = false;
+    std::unique_ptr<chunk_reader> reader_;
+};
+
+} // namespace detail
+
+/** An input view of the contents of a file, as consecutive
+    `std::span<const std::byte>` chunks of `chunk_size` bytes (the last may
+    be shorter), which keeps up to `depth` reads of the following chunks in
+    flight while the consumer works on the current one.
+
+    Used as the base of a `transform_view`, decoding a chunk overlaps with
+    reading the next ones, instead of the two alternating.  On Linux, reads
+    go through io_uring when the kernel allows it; otherwise, and with
+    `file_io::threads`, each read is a blocking call on one of `depth`
+    threads.  The file is opened, and its size taken, on construction, and
+    the reads start with the first call to `begin()`; a chunk's bytes stay
+    valid until the iterator is incremented.  Errors are reported as
+    `std::system_error`.  Meant for local files: a chunk is only delivered
+    once it has been read entirely. */
+class file_chunks_view : public std::ranges::view_interface<file_chunks_view> {
+    class iterator {
+      public:
+        using value_type      = std::span<const std::byte>;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        value_type operator*() const noexcept { return state_->current(); }
+
+        iterator& operator++() {
+            state_->advance();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) {
+            return it.state_->done();
+        }
+
+      private:
+        friend file_chunks_view;
+
+        explicit iterator(detail::file_chunks_state* state) : state_(state) {}
+
+        detail::file_chunks_state* state_ = nullptr;
+    };
+
+  public:
+    /** The default number of reads kept in flight. */
+    static constexpr std::size_t default_depth = 4;
+
+    /** Opens the file at `path`.  \pre `chunk_size > 0` */
+    file_chunks_view(const std::filesystem::path& path,
+                     std::size_t                  chunk_size,
+                     std::size_t                  depth = default_depth,
+                     file_io                      io    = file_io::automatic)
+        : state_(std::make_unique<detail::file_chunks_state>(
+              path, chunk_size, depth, io)) {}
+
+    /** Starts reading, and returns an iterator to the first chunk.  Must be
+        called at most once. */
+    iterator begin() {
+        state_->start();
+        return iterator(state_.get());
+    }
+
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+    /** Returns the size of the file when it was opened. */
+    std::uint64_t file_size() const noexcept { return state_->file_size(); }
+
+    /** Returns true iff the reads go through io_uring. */
+    bool uses_io_uring() const noexcept { return state_->uses_io_uring(); }
+
+  private:
+    std::unique_ptr<detail::file_chunks_state> state_;
+};
+
+namespace views {
+
+namespace detail {
+
+struct file_chunks_fn {
+    file_chunks_view operator() [[nodiscard]] (
+        const std::filesystem::path& path,
+        std::size_t                  chunk_size,
+        std::size_t                  depth = file_chunks_view::default_depth,
+        file_io                      io    = file_io::automatic) const {
+        return file_chunks_view(path, chunk_size, depth, io);
+    }
+};
+
+} // namespace detail
+
+/** Returns a `file_chunks_view` of the file at `path`. */
+inline constexpr detail::file_chunks_fn file_chunks;
+
+} // namespace views
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_FILE_CHUNKS_HPP
@@ -0,0 +1,251 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_INCREMENTAL_HPP
+#define BEMAN_TRANSFORM_VIEW_INCREMENTAL_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+namespace beman::transform_view {
+
+/** The fewest dirty 64-element words `incremental_transform::refresh(n)`
+    gives each thread; below that, threads cost more than they save. */
+inline constexpr std::size_t incremental_parallel_grain = 16;
+
+/** Owns the array `out[i] = f(base[i])` for a sized, random-access `V`, and
+    keeps it up to date by recomputing only the elements marked as changed.
+
+    After changing `base[i]`, call `mark(i)` (or `mark(first, last)` for a
+    run of elements); `refresh()` then recomputes just the marked elements,
+    in index order, in time proportional to their number.  Reads see the
+    values as of the last `refresh()`, and are plain array accesses: the
+    object is a contiguous range of `const T`, and `values()` returns a
+    `std::span`.  Dirty elements are tracked in a bitmap, along with a list
+    of the bitmap's non-zero words, so that neither marking nor refreshing
+    looks at clean parts of the array.
+
+    If `base`'s size has changed by the next `refresh()`, every element is
+    recomputed.  `refresh(threads)` splits the dirty elements among up to
+    `threads` threads, which call `f` concurrently. */
+template <std::ranges::random_access_range V, std::move_constructible F>
+    requires std::ranges::view<V> && std::ranges::sized_range<V> &&
+             std::is_object_v<F> &&
+             std::regular_invocable<F&, std::ranges::range_reference_t<V> >
+class incremental_transform {
+  public:
+    using value_type = std::remove_cvref_t<
+        std::invoke_result_t<F&, std::ranges::range_reference_t<V> > >;
+
+    static_assert(std::default_initializable<value_type> &&
+                      std::assignable_from<
+                          value_type&,
+                          std::invoke_result_t<
+                              F&,
+                              std::ranges::range_reference_t<V> > >,
+                  "incremental_transform stores its results in an array of "
+                  "value_type, and assigns new results to its elements.");
+
+    /** Computes every element. */
+    incremental_transform(V base, F f)
+        : base_(std::move(base)), fun_(std::move(f)) {
+        rebuild();
+    }
+
+    const V& base() const noexcept { return base_; }
+
+    std::size_t size() const noexcept { return size_; }
+
+    const value_type* data() const noexcept { return values_.get(); }
+    const value_type* begin() const noexcept { return data(); }
+    const value_type* end() const noexcept { return data() + size_; }
+
+    const value_type& operator[](std::size_t i) const noexcept {
+        return values_[i];
+    }
+
+    std::span<const value_type> values() const noexcept {
+        return {data(), size_};
+    }
+
+    /** Marks element `i` as changed.  `i` must be less than `size()`. */
+    void mark(std::size_t i) {
+        std::uint64_t& word = dirty_[i / 64];
+        if (word == 0)
+            dirty_words_.push_back(i / 64);
+        word |= std::uint64_t(1) << (i % 64);
+    }
+
+    /** Marks the elements in [first, last) as changed.  `last` must be at
+        most `size()`. */
+    void mark(std::size_t first, std::size_t last) {
+        while (first < last) {
+            const std::size_t w    = first / 64;
+            const std::size_t end  = std::min(last, (w + 1) * 64);
+            std::uint64_t     bits = ~std::uint64_t(0);
+            if (end - first < 64)
+                bits = ((std::uint64_t(1) << (end - first)) - 1)
+                       << (first % 64);
+            if (dirty_[w] == 0)
+                dirty_words_.push_back(w);
+            dirty_[w] |= bits;
+            first = end;
+        }
+    }
+
+    /** Marks every element as changed. */
+    void mark_all() { mark(0, size_); }
+
+    /** Returns the number of elements marked since the last refresh. */
+    std::size_t dirty_count() const noexcept {
+        std::size_t n = 0;
+        for (std::size_t w : dirty_words_)
+            n += std::size_t(std::popcount(dirty_[w]));
+        return n;
+    }
+
+    /** Recomputes the marked elements.  If `f` throws, the elements not yet
+        recomputed stay marked. */
+    void refresh() {
+        if (std::ranges::size(base_) != size_) {
+            rebuild();
+            return;
+        }
+        std::ranges::sort(dirty_words_);
+        try {
+            refresh_words(dirty_words_.data(),
+                          dirty_words_.data() + dirty_words_.size());
+        } catch (...) {
+            drop_clean_words();
+            throw;
+        }
+        dirty_words_.clear();
+    }
+
+    /** Recomputes the marked elements on up to `threads` threads, including
+        the calling one.  If `f` throws, the first exception is rethrown once
+        every thread has finished, and the elements not recomputed stay
+        marked. */
+    void refresh(std::size_t threads) {
+        const std::size_t n = std::min(
+            threads, dirty_words_.size() / incremental_parallel_grain);
+        if (n <= 1 || std::ranges::size(base_) != size_) {
+            refresh();
+            return;
+        }
+        std::ranges::sort(dirty_words_);
+
+        std::vector<std::exception_ptr> errors(n);
+        {
+            // Each thread gets a run of whole words, so no two threads touch
+            // the same word of the bitmap or the same element.
+            const std::size_t*       words = dirty_words_.data();
+            const std::size_t        total = dirty_words_.size();
+            std::vector<std::thread> workers;
+            workers.reserve(n - 1);
+            const auto piece = [&](std::size_t k) {
+                try {
+                    refresh_words(words + total * k / n,
+                                  words + total * (k + 1) / n);
+                } catch (...) {
+                    errors[k] = std::current_exception();
+                }
+            };
+            try {
+                for (std::size_t k = 1; k < n; ++k)
+                    workers.emplace_back(piece, k);
+            } catch (...) {
+                for (std::thread& t : workers)
+                    t.join();
+                throw;
+            }
+            piece(0);
+            for (std::thread& t : workers)
+                t.join();
+        }
+        for (const std::exception_ptr& e : errors) {
+            if (e) {
+                drop_clean_words();
+                std::rethrow_exception(e);
+            }
+        }
+        dirty_words_.clear();
+    }
+
+  private:
+    // Forgets the listed words that have no marked elements left, so that
+    // none is listed twice once marked again.
+    void drop_clean_words() {
+        std::erase_if(dirty_words_,
+                      [this](std::size_t w) { return dirty_[w] == 0; });
+    }
+
+    void rebuild() {
+        const std::size_t size   = std::ranges::size(base_);
+        auto              values = std::make_unique<value_type[]>(size);
+        auto              first  = std::ranges::begin(base_);
+        for (std::size_t i = 0; i < size; ++i)
+            values[i] = detail::invoke(*fun_, first[std::ptrdiff_t(i)]);
+        values_ = std::move(values);
+        size_   = size;
+        dirty_.assign((size + 63) / 64, 0);
+        dirty_words_.clear();
+    }
+
+    // Recomputes the marked elements of the words listed in [first, last),
+    // clearing each element's bit once its new value is stored.
+    void refresh_words(const std::size_t* first,
+                       const std::size_t* last) {
+        auto base = std::ranges::begin(base_);
+        for (; first != last; ++first) {
+            std::uint64_t& word = dirty_[*first];
+            while (word != 0) {
+                const std::size_t i =
+                    *first * 64 + std::size_t(std::countr_zero(word));
+                values_[i] = detail::invoke(*fun_, base[std::ptrdiff_t(i)]);
+                word &= word - 1;
+            }
+        }
+    }
+
+    V                                            base_;
+    BEMAN_TRANSFORM_VIEW_NO_UNIQUE_ADDRESS detail::movable_box<F> fun_;
+    std::unique_ptr<value_type[]>                values_;
+    std::size_t                                  size_ = 0;
+    std::vector<std::uint64_t>                   dirty_;
+    std::vector<std::size_t>                     dirty_words_;
+};
+
+template <typename R, typename F>
+incremental_transform(R&&, F)
+    -> incremental_transform<std::views::all_t<R>, F>;
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_INCREMENTAL_HPP
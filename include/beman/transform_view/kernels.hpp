@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_KERNELS_HPP
+#define BEMAN_TRANSFORM_VIEW_KERNELS_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#endif
+
+// BEMAN_TRANSFORM_VIEW_HAS_KERNELS is defined by the
+// beman.transform_view.kernels target for everything that links to it.  When
+// it is not defined, every kernel below is a portable, header-only loop.
+
+namespace beman::transform_view::kernels {
+
+/** The instruction sets the compiled kernels are built for. */
+enum class isa { portable, sse2, avx2, avx512 };
+
+/** Tidy callable returning `-x`. */
+struct negate_fn {
+    template <typename T>
+    constexpr T operator()(T x) const noexcept {
+        return -x;
+    }
+};
+
+/** Tidy callable returning the absolute value of `x`. */
+struct abs_fn {
+    template <typename T>
+    constexpr T operator()(T x) const noexcept {
+        return x < T(0) ? -x : x;
+    }
+};
+
+/** Tidy callable returning `x * x`. */
+struct square_fn {
+    template <typename T>
+    constexpr T operator()(T x) const noexcept {
+        return x * x;
+    }
+};
+
+/** Tidy callable mapping ASCII 'A'-'Z' to 'a'-'z'. */
+struct ascii_to_lower_fn {
+    constexpr char operator()(char c) const noexcept {
+        return 'A' <= c && c <= 'Z' ? char(c + ('a' - 'A')) : c;
+    }
+};
+
+/** Tidy callable mapping ASCII 'a'-'z' to 'A'-'Z'. */
+struct ascii_to_upper_fn {
+    constexpr char operator()(char c) const noexcept {
+        return 'a' <= c && c <= 'z' ? char(c - ('a' - 'A')) : c;
+    }
+};
+
+inline constexpr negate_fn         negate;
+inline constexpr abs_fn            abs;
+inline constexpr square_fn         square;
+inline constexpr ascii_to_lower_fn ascii_to_lower;
+inline constexpr ascii_to_upper_fn ascii_to_upper;
+
+/** True iff there is a bulk kernel applying `Op` to a sequence of `T`. */
+template <typename Op, typename T>
+concept has_kernel =
+    ((std::same_as<Op, negate_fn> || std::same_as<Op, abs_fn> ||
+      std::same_as<Op, square_fn>) &&
+     (std::same_as<T, float> || std::same_as<T, double> ||
+      std::same_as<T, std::int32_t> || std::same_as<T, std::int64_t>)) ||
+    ((std::same_as<Op, ascii_to_lower_fn> ||
+      std::same_as<Op, ascii_to_upper_fn>) &&
+     std::same_as<T, char>);
+
+namespace detail {
+
+template <typename Op, typename T>
+constexpr void portable_kernel(const T* in, std::size_t n, T* out) noexcept {
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = Op()(in[i]);
+}
+
+template <typename R, typename T>
+concept kernel_view =
+    std::ranges::contiguous_range<decltype(std::declval<R>().base())> &&
+    std::ranges::sized_range<decltype(std::declval<R>().base())> &&
+    std::same_as<std::ranges::range_value_t<R>, T> &&
+    beman::transform_view::detail::transform_view_traits<
+        std::remove_cvref_t<R> >::is_transform_view &&
+    has_kernel<typename beman::transform_view::detail::transform_view_traits<
+                   std::remove_cvref_t<R> >::func_type,
+               T>;
+
+#if defined(BEMAN_TRANSFORM_VIEW_HAS_KERNELS)
+// Defined and explicitly instantiated by the compiled component, for each
+// has_kernel combination.
+template <typename Op, typename T>
+void dispatched_kernel(const T* in, std::size_t n, T* out) noexcept;
+
+isa select_isa() noexcept;
+#endif
+
+} // namespace detail
+
+/** Returns the instruction set the kernels selected at startup, or
+    `isa::portable` if the compiled component is not linked in. */
+inline isa selected_isa() noexcept {
+#if defined(BEMAN_TRANSFORM_VIEW_HAS_KERNELS)
+    return detail::select_isa();
+#else
+    return isa::portable;
+#endif
+}
+
+/** Writes `Op()(x)` for each `x` in `in` to the corresponding element of
+    `out`, using the widest instruction set the host supports.  `out` may
+    be `in`, to transform in place.
+
+    \pre `in.size() <= out.size()`, and `out` either begins at `in.data()`
+    or does not overlap `in`. */
+template <typename Op, typename T>
+    requires has_kernel<Op, T>
+void transform(std::span<const std::type_identity_t<T> > in,
+               std::span<T>                              out,
+               Op = Op()) {
+#if defined(BEMAN_TRANSFORM_VIEW_HAS_KERNELS)
+    detail::dispatched_kernel<Op, T>(in.data(), in.size(), out.data());
+#else
+    detail::portable_kernel<Op, T>(in.data(), in.size(), out.data());
+#endif
+}
+
+/** Copies the elements of `view` into the contiguous range `out`, and
+    returns the unused remainder of `out` as a `std::span`.  When `view`
+    applies one of the kernel callables above to a contiguous range, this uses
+    `transform()`; otherwise it is `std::ranges::copy()`.
+
+    \pre `std::ranges::size(view) <= std::ranges::size(out)`, and `out`
+    either begins where `view`'s base does or does not overlap it. */
+template <std::ranges::input_range R, std::ranges::contiguous_range Out>
+    requires std::ranges::sized_range<R> && std::ranges::sized_range<Out> &&
+             std::indirectly_copyable<std::ranges::iterator_t<R>,
+                                      std::ranges::iterator_t<Out> >
+auto copy(R&& view, Out&& out) {
+    using T = std::remove_reference_t<std::ranges::range_reference_t<Out> >;
+    std::span<T> out_span(std::ranges::data(out), std::ranges::size(out));
+    if constexpr (detail::kernel_view<R&, std::remove_const_t<T> >) {
+        using Op = typename beman::transform_view::detail::
+            transform_view_traits<std::remove_cvref_t<R> >::func_type;
+        auto base = view.base();
+        kernels::transform<Op, T>(
+            std::span<const T>(std::ranges::data(base),
+                               std::ranges::size(base)),
+            out_span);
+    } else {
+        std::ranges::copy(view, out_span.begin());
+    }
+    return out_span.subspan(std::ranges::size(view));
+}
+
+} // namespace beman::transform_view::kernels
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_KERNELS_HPP
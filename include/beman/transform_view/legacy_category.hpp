@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_LEGACY_CATEGORY_HPP
+#define BEMAN_TRANSFORM_VIEW_LEGACY_CATEGORY_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <concepts>
+#include <functional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#endif
+
+namespace beman::transform_view {
+
+/** Wraps a callable `F`, forwarding calls to it, so that `transform_view`s
+    using it report their base's iterator category; see
+    `enable_legacy_iterator_category`.  It is tidy whenever `F` is. */
+template <std::move_constructible F>
+    requires std::is_object_v<F>
+struct legacy_category_fn {
+    BEMAN_TRANSFORM_VIEW_NO_UNIQUE_ADDRESS F f;
+
+    template <typename... Args>
+        requires std::invocable<F&, Args...>
+    constexpr decltype(auto) operator()(Args&&... args) & noexcept(
+        std::is_nothrow_invocable_v<F&, Args...>) {
+        return std::invoke(f, (Args&&)args...);
+    }
+
+    template <typename... Args>
+        requires std::invocable<const F&, Args...>
+    constexpr decltype(auto) operator()(Args&&... args) const& noexcept(
+        std::is_nothrow_invocable_v<const F&, Args...>) {
+        return std::invoke(f, (Args&&)args...);
+    }
+};
+
+template <typename F>
+constexpr bool enable_legacy_iterator_category<legacy_category_fn<F> > = true;
+
+namespace views {
+
+namespace detail {
+
+struct transform_legacy_impl {
+    template <std::ranges::viewable_range Range,
+              typename F,
+              typename G = legacy_category_fn<std::decay_t<F> > >
+        requires can_transform_view<Range, G>
+    constexpr auto operator() [[nodiscard]] (Range&& r, F&& f) const {
+        return transform_view((Range&&)r, G{(F&&)f});
+    }
+};
+
+} // namespace detail
+
+/** Like `views::transform`, except that the resulting view's iterators
+    report the iterator category of the underlying range, up to random
+    access, even though `F` returns by value. */
+inline constexpr detail::adaptor<detail::transform_legacy_impl>
+    transform_legacy = detail::transform_legacy_impl{};
+
+} // namespace views
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_LEGACY_CATEGORY_HPP
@@ -0,0 +1,323 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_LUT_HPP
+#define BEMAN_TRANSFORM_VIEW_LUT_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#endif
+
+// The bulk path of a lookup-table transform uses byte shuffles on x86 with
+// GCC or Clang.  Each version carries its own target attribute, so its body
+// is the same whatever flags a translation unit is compiled with, and the
+// widest version the host supports is chosen at run time.
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES() &&            \
+    (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define BEMAN_TRANSFORM_VIEW_LUT_SHUFFLE 1
+#define BEMAN_TRANSFORM_VIEW_LUT_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#else
+#define BEMAN_TRANSFORM_VIEW_LUT_SHUFFLE 0
+#endif
+
+namespace beman::transform_view {
+
+namespace detail {
+
+// The input types small enough to tabulate: 8- and 16-bit integers and
+// character types, and std::byte.
+template <typename T>
+concept lut_input =
+    ((std::integral<T> && !std::same_as<T, bool>) ||
+     std::same_as<T, std::byte>) &&
+    sizeof(T) <= 2 && std::same_as<T, std::remove_cv_t<T> >;
+
+template <lut_input T>
+constexpr std::size_t lut_index(T x) noexcept {
+    if constexpr (std::same_as<T, std::byte>)
+        return std::to_integer<unsigned char>(x);
+    else
+        return static_cast<std::make_unsigned_t<T> >(x);
+}
+
+template <lut_input T>
+constexpr T lut_value(std::size_t i) noexcept {
+    if constexpr (std::same_as<T, std::byte>)
+        return std::byte(i);
+    else
+        return T(static_cast<std::make_unsigned_t<T> >(i));
+}
+
+template <typename F, typename T>
+using lut_result_t = std::remove_cvref_t<std::invoke_result_t<const F&, T> >;
+
+template <typename F, typename T>
+concept lut_evaluable =
+    lut_input<T> && tidy_func<F> && std::regular_invocable<const F&, T> &&
+    std::default_initializable<lut_result_t<F, T> > &&
+    std::copyable<lut_result_t<F, T> > &&
+    requires { typename std::bool_constant<(void(F()(T())), true)>; };
+
+template <typename F, typename T>
+struct lut_table {
+    using result_type = lut_result_t<F, T>;
+
+    static constexpr std::size_t size = std::size_t(1) << (8 * sizeof(T));
+
+    static constexpr std::array<result_type, size> values = [] {
+        std::array<result_type, size> result{};
+        for (std::size_t i = 0; i < size; ++i)
+            result[i] = std::invoke(F(), detail::lut_value<T>(i));
+        return result;
+    }();
+};
+
+#if BEMAN_TRANSFORM_VIEW_LUT_SHUFFLE
+// Each shuffle_lut_* looks up each byte of in in the 256-byte table, a vector
+// at a time, and returns the number of bytes done.
+using shuffle_lut_fn = std::size_t (*)(const unsigned char*,
+                                       const unsigned char*,
+                                       std::size_t,
+                                       unsigned char*) noexcept;
+
+// Each two-table byte permute covers half of the table, indexed by the low 7
+// bits of the input; bit 7 picks a half.
+BEMAN_TRANSFORM_VIEW_LUT_TARGET("avx512f,avx512bw,avx512vbmi")
+inline std::size_t shuffle_lut_avx512(const unsigned char* table,
+                                      const unsigned char* in,
+                                      std::size_t          n,
+                                      unsigned char*       out) noexcept {
+    const __m512i t0 = _mm512_loadu_si512(table);
+    const __m512i t1 = _mm512_loadu_si512(table + 64);
+    const __m512i t2 = _mm512_loadu_si512(table + 128);
+    const __m512i t3 = _mm512_loadu_si512(table + 192);
+
+    std::size_t i = 0;
+    for (; 64 <= n - i; i += 64) {
+        const __m512i   v  = _mm512_loadu_si512(in + i);
+        const __m512i   lo = _mm512_permutex2var_epi8(t0, v, t1);
+        const __m512i   hi = _mm512_permutex2var_epi8(t2, v, t3);
+        const __mmask64 m  = _mm512_movepi8_mask(v);
+        _mm512_storeu_si512(out + i, _mm512_mask_blend_epi8(m, lo, hi));
+    }
+    return i;
+}
+
+// The AVX2 and SSE4.1 versions split the table into 16 rows of 16 bytes;
+// each row is shuffled by the low nibbles of the input, and the results are
+// narrowed down to the right row by four rounds of blends, each keyed on one
+// bit of the high nibble (shifted up to bit 7 of its byte, where blendv looks
+// for it).  Blending as soon as both inputs exist keeps at most five vectors
+// live, instead of all sixteen shuffled rows.  The two are spelled out
+// separately because helpers shared between them could not be inlined into
+// both targets.
+BEMAN_TRANSFORM_VIEW_LUT_TARGET("avx2")
+inline std::size_t shuffle_lut_avx2(const unsigned char* table,
+                                    const unsigned char* in,
+                                    std::size_t          n,
+                                    unsigned char*       out) noexcept {
+    // Broadcasts row k of the table to both lanes.
+    const auto row = [table](int k) BEMAN_TRANSFORM_VIEW_LUT_TARGET("avx2") {
+        return _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16 * k)));
+    };
+
+    std::size_t i = 0;
+    for (; 32 <= n - i; i += 32) {
+        const __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const __m256i lo   = _mm256_and_si256(v, _mm256_set1_epi8(0x0f));
+        const __m256i bit4 = _mm256_slli_epi16(v, 3);
+        const __m256i bit5 = _mm256_slli_epi16(v, 2);
+        const __m256i bit6 = _mm256_slli_epi16(v, 1);
+
+        __m256i r[4];
+        for (int k = 0; k < 4; ++k) {
+            const __m256i a =
+                _mm256_blendv_epi8(_mm256_shuffle_epi8(row(4 * k), lo),
+                                   _mm256_shuffle_epi8(row(4 * k + 1), lo),
+                                   bit4);
+            const __m256i b =
+                _mm256_blendv_epi8(_mm256_shuffle_epi8(row(4 * k + 2), lo),
+                                   _mm256_shuffle_epi8(row(4 * k + 3), lo),
+                                   bit4);
+            r[k] = _mm256_blendv_epi8(a, b, bit5);
+        }
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out + i),
+            _mm256_blendv_epi8(_mm256_blendv_epi8(r[0], r[1], bit6),
+                               _mm256_blendv_epi8(r[2], r[3], bit6),
+                               v));
+    }
+    return i;
+}
+
+BEMAN_TRANSFORM_VIEW_LUT_TARGET("sse4.1")
+inline std::size_t shuffle_lut_sse41(const unsigned char* table,
+                                     const unsigned char* in,
+                                     std::size_t          n,
+                                     unsigned char*       out) noexcept {
+    std::size_t i = 0;
+    for (; 16 <= n - i; i += 16) {
+        const __m128i v =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i lo   = _mm_and_si128(v, _mm_set1_epi8(0x0f));
+        const __m128i bit4 = _mm_slli_epi16(v, 3);
+        const __m128i bit5 = _mm_slli_epi16(v, 2);
+        const __m128i bit6 = _mm_slli_epi16(v, 1);
+
+        __m128i r[4];
+        for (int k = 0; k < 4; ++k) {
+            const __m128i* row =
+                reinterpret_cast<const __m128i*>(table + 64 * k);
+            const __m128i a =
+                _mm_blendv_epi8(_mm_shuffle_epi8(_mm_loadu_si128(row), lo),
+                                _mm_shuffle_epi8(_mm_loadu_si128(row + 1), lo),
+                                bit4);
+            const __m128i b =
+                _mm_blendv_epi8(_mm_shuffle_epi8(_mm_loadu_si128(row + 2), lo),
+                                _mm_shuffle_epi8(_mm_loadu_si128(row + 3), lo),
+                                bit4);
+            r[k] = _mm_blendv_epi8(a, b, bit5);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm_blendv_epi8(_mm_blendv_epi8(r[0], r[1], bit6),
+                                         _mm_blendv_epi8(r[2], r[3], bit6),
+                                         v));
+    }
+    return i;
+}
+
+inline std::size_t shuffle_lut_none(const unsigned char*,
+                                    const unsigned char*,
+                                    std::size_t,
+                                    unsigned char*) noexcept {
+    return 0;
+}
+
+inline shuffle_lut_fn select_shuffle_lut() noexcept {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vbmi"))
+        return &shuffle_lut_avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return &shuffle_lut_avx2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return &shuffle_lut_sse41;
+    return &shuffle_lut_none;
+}
+
+// Chooses a version the first time it is called.
+inline std::size_t shuffle_lut(const unsigned char* table,
+                               const unsigned char* in,
+                               std::size_t          n,
+                               unsigned char*       out) noexcept {
+    static const shuffle_lut_fn fn = detail::select_shuffle_lut();
+    return fn(table, in, n, out);
+}
+#endif
+
+template <typename T, typename R>
+constexpr void
+lut_transform(const R* table, const T* in, std::size_t n, R* out) noexcept {
+    std::size_t i = 0;
+#if BEMAN_TRANSFORM_VIEW_LUT_SHUFFLE
+    if constexpr (sizeof(T) == 1 && sizeof(R) == 1 &&
+                  std::is_trivially_copyable_v<R>) {
+        if (!std::is_constant_evaluated()) {
+            i = detail::shuffle_lut(
+                reinterpret_cast<const unsigned char*>(table),
+                reinterpret_cast<const unsigned char*>(in),
+                n,
+                reinterpret_cast<unsigned char*>(out));
+        }
+    }
+#endif
+    for (; i < n; ++i)
+        out[i] = table[detail::lut_index(in[i])];
+}
+
+} // namespace detail
+
+/** A tidy callable that returns `F()(x)` by looking it up in a table of the
+    results of `F` over every value of `x`'s type, built at compile time.
+    Inputs must be 8- or 16-bit integer or character types, or `std::byte`;
+    `F` must be tidy and invocable in constant expressions.  A 16-bit table
+    has 65536 entries, so building it may need a higher constexpr step
+    limit.
+
+    It is also `batch_invocable` (see `<beman/transform_view/batch.hpp>`);
+    when both the input and the result are one byte wide and the host
+    supports SSE4.1, AVX2 or AVX-512 VBMI, batches are translated 16, 32 or
+    64 bytes at a time with byte shuffles.  The instruction set is detected
+    at run time, so no compiler flags are needed. */
+template <typename F>
+    requires detail::tidy_func<F>
+struct lut_fn {
+    template <typename T>
+        requires detail::lut_evaluable<F, T>
+    constexpr detail::lut_result_t<F, T> operator()(T x) const noexcept {
+        return detail::lut_table<F, T>::values[detail::lut_index(x)];
+    }
+
+    template <typename T, typename Out>
+        requires detail::lut_evaluable<F, T> &&
+                 std::same_as<Out, detail::lut_result_t<F, T> >
+    constexpr void operator()(std::span<const T> in,
+                              std::span<Out>     out) const noexcept {
+        detail::lut_transform(detail::lut_table<F, T>::values.data(),
+                              in.data(),
+                              in.size(),
+                              out.data());
+    }
+};
+
+namespace views {
+
+namespace detail {
+
+struct transform_lut_impl {
+    template <std::ranges::viewable_range Range,
+              typename F,
+              typename G = std::remove_cvref_t<F> >
+        requires beman::transform_view::detail::tidy_func<G> &&
+                 can_transform_view<Range, beman::transform_view::lut_fn<G> >
+    constexpr auto operator() [[nodiscard]] (Range&& r, F&&) const {
+        return transform_view((Range&&)r, beman::transform_view::lut_fn<G>());
+    }
+};
+
+} // namespace detail
+
+/** Like `views::transform`, except that `F` is replaced by `lut_fn<F>`: its
+    results are looked up in a table computed at compile time. */
+inline constexpr detail::adaptor<detail::transform_lut_impl> transform_lut =
+    detail::transform_lut_impl{};
+
+} // namespace views
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_LUT_HPP
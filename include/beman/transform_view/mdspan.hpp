@@ -0,0 +1,331 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_MDSPAN_HPP
+#define BEMAN_TRANSFORM_VIEW_MDSPAN_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+#include <beman/transform_view/reduce.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <version>
+#if __has_include(<mdspan>)
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <mdspan>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#endif
+#endif
+
+// Everything below needs std::mdspan, which standard libraries added after
+// the rest of C++23 (e.g. libstdc++ 14, libc++ 17).
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() || defined(__cpp_lib_mdspan)
+
+namespace beman::transform_view {
+
+/** An accessor policy for `std::mdspan` whose elements are `f(x)`, for each
+    element `x` produced by the accessor `Accessor`.  Elements are computed
+    on every access; nothing is stored.  `F` takes no space when it is an
+    empty class, e.g. a tidy callable. */
+template <typename F, typename Accessor>
+    requires std::copy_constructible<F> && std::is_object_v<F> &&
+             std::regular_invocable<const F&, typename Accessor::reference>
+class transform_accessor {
+  public:
+    using offset_policy =
+        transform_accessor<F, typename Accessor::offset_policy>;
+    using reference = std::invoke_result_t<const F&,
+                                           typename Accessor::reference>;
+    using element_type     = std::remove_reference_t<reference>;
+    using data_handle_type = typename Accessor::data_handle_type;
+
+    constexpr transform_accessor()
+        requires std::default_initializable<F> &&
+                 std::default_initializable<Accessor>
+    = default;
+
+    constexpr transform_accessor(Accessor base, F f)
+        : base_(std::move(base)), f_(std::move(f)) {}
+
+    template <typename OtherAccessor>
+        requires std::constructible_from<Accessor, const OtherAccessor&>
+    constexpr explicit(!std::convertible_to<const OtherAccessor&, Accessor>)
+        transform_accessor(const transform_accessor<F, OtherAccessor>& other)
+        : base_(other.base()), f_(other.func()) {}
+
+    constexpr reference access(data_handle_type p, std::size_t i) const {
+        return detail::invoke(f_, base_.access(p, i));
+    }
+
+    constexpr typename offset_policy::data_handle_type
+    offset(data_handle_type p, std::size_t i) const {
+        return base_.offset(p, i);
+    }
+
+    constexpr const Accessor& base() const noexcept { return base_; }
+    constexpr const F&        func() const noexcept { return f_; }
+
+  private:
+    BEMAN_TRANSFORM_VIEW_NO_UNIQUE_ADDRESS Accessor base_ = Accessor();
+    BEMAN_TRANSFORM_VIEW_NO_UNIQUE_ADDRESS F        f_    = F();
+};
+
+/** Returns a `std::mdspan` with the same extents and layout mapping as
+    `md`, whose element at each index is `f(md[index])`, computed when it is
+    accessed.  Like `md`, the result does not own its elements (and, for a
+    tidy `f`, is the same size as `md`), so it can be passed by value and
+    outlive the expression that made it.  Applying `transform_mdspan()` to
+    its result composes the callables into one accessor. */
+template <typename T,
+          typename Extents,
+          typename Layout,
+          typename Accessor,
+          typename F>
+    requires std::copy_constructible<std::decay_t<F> > &&
+             std::regular_invocable<const std::decay_t<F>&,
+                                    typename Accessor::reference>
+constexpr auto
+transform_mdspan(const std::mdspan<T, Extents, Layout, Accessor>& md, F&& f) {
+    using accessor = transform_accessor<std::decay_t<F>, Accessor>;
+    return std::mdspan<typename accessor::element_type,
+                       Extents,
+                       Layout,
+                       accessor>(
+        md.data_handle(), md.mapping(), accessor(md.accessor(), (F&&)f));
+}
+
+namespace detail {
+
+// The number of indices along each of the two dimensions of a tile, when a
+// copy between mdspans with different fast dimensions is blocked.
+inline constexpr std::size_t mdspan_tile = 32;
+
+template <typename M>
+inline constexpr std::size_t mapping_rank = M::extents_type::rank();
+
+// Returns the dimensions of m from the one with the largest stride to the
+// one with the smallest, i.e. in the order in which nested loops should
+// visit them.  Layouts that are not strided are visited like layout_right.
+template <typename M>
+constexpr std::array<std::size_t, mapping_rank<M> >
+traversal_order([[maybe_unused]] const M& m) {
+    std::array<std::size_t, mapping_rank<M> > order;
+    for (std::size_t d = 0; d < order.size(); ++d)
+        order[d] = d;
+    using layout = typename M::layout_type;
+    if constexpr (std::same_as<layout, std::layout_left>) {
+        std::ranges::reverse(order);
+    } else if constexpr (!std::same_as<layout, std::layout_right> &&
+                         M::is_always_strided()) {
+        std::ranges::stable_sort(order, std::ranges::greater(), [&m](auto d) {
+            return m.stride(d);
+        });
+    }
+    return order;
+}
+
+template <typename M, typename Index>
+constexpr auto map_index(const M& m, const Index& idx) {
+    return std::apply([&m](auto... i) { return m(i...); }, idx);
+}
+
+// Sets idx[dims[0]], ..., idx[dims[n - 1]] to each combination of indices
+// within e, in nested order, and calls f() for each.
+template <typename Extents, typename Index, typename F>
+constexpr void for_each_outer(const Extents&     e,
+                              Index&             idx,
+                              const std::size_t* dims,
+                              std::size_t        n,
+                              F&                 f) {
+    if (n == 0) {
+        f();
+        return;
+    }
+    for (idx[*dims] = 0; idx[*dims] < e.extent(*dims); ++idx[*dims])
+        detail::for_each_outer(e, idx, dims + 1, n - 1, f);
+}
+
+// Calls run(idx, n) for each run of n consecutive indices along the last
+// dimension in order, starting at idx, with the other dimensions visited in
+// order.  If blocked is another dimension, that one and the last one are
+// visited in mdspan_tile x mdspan_tile tiles, so that the lines touched
+// along both stay in cache while the tile is done.
+template <typename Extents, typename Run>
+constexpr void
+for_each_run(const Extents&                                   e,
+             const std::array<std::size_t, Extents::rank()>& order,
+             std::size_t                                     blocked,
+             Run                                             run) {
+    using index_type           = typename Extents::index_type;
+    constexpr std::size_t rank = Extents::rank();
+
+    std::array<index_type, rank> idx{};
+    const std::size_t            inner = order[rank - 1];
+    if (blocked == inner || blocked >= rank) {
+        auto body = [&] {
+            idx[inner] = 0;
+            run(std::as_const(idx), e.extent(inner));
+        };
+        detail::for_each_outer(e, idx, order.data(), rank - 1, body);
+        return;
+    }
+
+    std::array<std::size_t, rank> outer{};
+    std::size_t                   n = 0;
+    for (std::size_t d : order) {
+        if (d != inner && d != blocked)
+            outer[n++] = d;
+    }
+    const auto tile = index_type(mdspan_tile);
+    auto       body = [&] {
+        const index_type rows = e.extent(blocked);
+        const index_type cols = e.extent(inner);
+        for (index_type r0 = 0; r0 < rows; r0 += tile) {
+            for (index_type c0 = 0; c0 < cols; c0 += tile) {
+                const index_type r1 = (std::min)(rows, index_type(r0 + tile));
+                for (index_type r = r0; r < r1; ++r) {
+                    idx[blocked] = r;
+                    idx[inner]   = c0;
+                    run(std::as_const(idx), (std::min)(tile, cols - c0));
+                }
+            }
+        }
+    };
+    detail::for_each_outer(e, idx, outer.data(), n, body);
+}
+
+// Returns a callable giving the k-th element of md along dimension d from
+// idx.  For a strided mapping, that is an offset computed once plus k
+// times the stride, so the loops over it can vectorize.
+template <typename MDSpan, typename Index>
+constexpr auto run_access(const MDSpan& md, const Index& idx, std::size_t d) {
+    using index_type = typename MDSpan::index_type;
+    using reference  = typename MDSpan::reference;
+    using mapping    = typename MDSpan::mapping_type;
+    if constexpr (mapping::is_always_strided()) {
+        const index_type offset = detail::map_index(md.mapping(), idx);
+        const index_type stride = md.mapping().stride(d);
+        return [&acc = md.accessor(),
+                p    = md.data_handle(),
+                offset,
+                stride](index_type k) -> reference {
+            return acc.access(p, std::size_t(offset + k * stride));
+        };
+    } else {
+        return [&md, idx, d](index_type k) -> reference {
+            auto i = idx;
+            i[d] += k;
+            return md[i];
+        };
+    }
+}
+
+} // namespace detail
+
+/** Writes each element of `src` to the element of `dst` at the same index.
+    Both are traversed in the order of `src`'s layout, so that the innermost
+    loop runs along its smallest stride: layout_right's last dimension,
+    layout_left's first, or the smallest stride of layout_stride.  When that
+    is not also `dst`'s fast dimension, as in a transpose, the two fast
+    dimensions are copied in tiles, so that the lines touched in both stay
+    in cache.  With a `transform_mdspan()` as `src`, this materializes it.
+
+    \pre `src.extents() == dst.extents()` */
+template <typename T,
+          typename SrcExtents,
+          typename SrcLayout,
+          typename SrcAccessor,
+          typename U,
+          typename DstExtents,
+          typename DstLayout,
+          typename DstAccessor>
+    requires(SrcExtents::rank() == DstExtents::rank()) &&
+            std::is_assignable_v<typename DstAccessor::reference,
+                                 typename SrcAccessor::reference>
+constexpr void
+materialize(const std::mdspan<T, SrcExtents, SrcLayout, SrcAccessor>& src,
+            const std::mdspan<U, DstExtents, DstLayout, DstAccessor>& dst) {
+    constexpr std::size_t rank = SrcExtents::rank();
+    if constexpr (rank == 0) {
+        dst[] = src[];
+    } else {
+        const auto order = detail::traversal_order(src.mapping());
+        const auto dst_inner =
+            detail::traversal_order(dst.mapping())[rank - 1];
+        const std::size_t inner = order[rank - 1];
+        detail::for_each_run(
+            src.extents(), order, dst_inner, [&](const auto& idx, auto n) {
+                using index_type = std::remove_cvref_t<decltype(n)>;
+                auto in          = detail::run_access(src, idx, inner);
+                auto out         = detail::run_access(dst, idx, inner);
+                for (index_type k = 0; k < n; ++k)
+                    out(k) = in(k);
+            });
+    }
+}
+
+/** Returns the sum, under `op`, of `init` and every element of `md`, where
+    `op` is associative and commutative.  The elements are visited in the
+    order of `md`'s layout (see `materialize()`), and each run along its
+    fast dimension is folded with the unordered `reduce()` for ranges. */
+template <std::size_t K = 4,
+          typename T,
+          typename Extents,
+          typename Layout,
+          typename Accessor,
+          typename U,
+          typename Op = std::plus<> >
+    requires(0 < K) && std::movable<U> &&
+            std::invocable<Op&, U, typename Accessor::reference> &&
+            std::invocable<Op&, U, U> &&
+            std::assignable_from<
+                U&,
+                std::invoke_result_t<Op&, U, typename Accessor::reference> > &&
+            std::assignable_from<U&, std::invoke_result_t<Op&, U, U> >
+constexpr U reduce(unordered_t,
+                   const std::mdspan<T, Extents, Layout, Accessor>& md,
+                   U                                                init,
+                   Op                                               op = Op()) {
+    constexpr std::size_t rank = Extents::rank();
+    U                     acc  = std::move(init);
+    if constexpr (rank == 0) {
+        acc = std::invoke(op, std::move(acc), md[]);
+    } else {
+        const auto        order = detail::traversal_order(md.mapping());
+        const std::size_t inner = order[rank - 1];
+        detail::for_each_run(
+            md.extents(), order, rank, [&](const auto& idx, auto n) {
+                using index_type = std::remove_cvref_t<decltype(n)>;
+                acc              = beman::transform_view::reduce<K>(
+                    unordered,
+                    transform_view(std::views::iota(index_type(0), n),
+                                   detail::run_access(md, idx, inner)),
+                    std::move(acc),
+                    std::ref(op));
+            });
+    }
+    return acc;
+}
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() || defined(__cpp_lib_mdspan)
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_MDSPAN_HPP
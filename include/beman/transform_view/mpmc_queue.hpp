@@ -0,0 +1,468 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_MPMC_QUEUE_HPP
+#define BEMAN_TRANSFORM_VIEW_MPMC_QUEUE_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#endif
+
+// Spinning waiters execute a pause instruction per iteration, which frees
+// the core's resources for its sibling hyperthread.
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64))
+#define BEMAN_TRANSFORM_VIEW_SPIN_PAUSE 1
+#include <immintrin.h>
+#else
+#define BEMAN_TRANSFORM_VIEW_SPIN_PAUSE 0
+#endif
+
+namespace beman::transform_view {
+
+/** The default number of elements a `drain_view` claims from its queue at a
+    time. */
+inline constexpr std::size_t drain_batch = 32;
+
+namespace detail {
+
+inline void cpu_relax() noexcept {
+#if BEMAN_TRANSFORM_VIEW_SPIN_PAUSE
+    _mm_pause();
+#endif
+}
+
+// Lets threads wait, without a lock, for a condition that other threads
+// make true.  A waiter spins for a while first, for about as long as it
+// recently took for the condition to come true, and then sleeps in
+// std::atomic::wait.  notify() costs one atomic read-modify-write unless a
+// thread is asleep.
+class event_count {
+  public:
+    // Returns once ready() has returned true.  ready() is called many times,
+    // and possibly on several threads at once.
+    template <typename Pred>
+    void wait_until(Pred ready) noexcept {
+        const int estimate = spin_.load(std::memory_order_relaxed);
+        const int limit    = std::min(max_spin, 2 * estimate + 16);
+        for (int i = 0; i < limit; ++i) {
+            if (ready()) {
+                spin_.store(estimate + (i - estimate) / 8,
+                            std::memory_order_relaxed);
+                return;
+            }
+            detail::cpu_relax();
+        }
+        // Spinning did not pay off: spin less next time.
+        spin_.store(estimate / 2, std::memory_order_relaxed);
+
+        for (;;) {
+            const std::uint32_t epoch = epoch_.load(std::memory_order_acquire);
+            // Both this and notify() read and write sleepers_, so either
+            // this sees the notifier's change, or the notifier sees this
+            // thread among the sleepers.
+            sleepers_.fetch_add(1, std::memory_order_acq_rel);
+            const bool done = ready();
+            if (!done)
+                epoch_.wait(epoch, std::memory_order_acquire);
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            if (done || ready())
+                return;
+        }
+    }
+
+    // Wakes the sleeping waiters; to be called after making their condition
+    // true.
+    void notify() noexcept {
+        if (sleepers_.fetch_add(0, std::memory_order_acq_rel) != 0) {
+            epoch_.fetch_add(1, std::memory_order_release);
+            epoch_.notify_all();
+        }
+    }
+
+  private:
+    static constexpr int max_spin = 256;
+
+    std::atomic<std::uint32_t> epoch_{0};
+    std::atomic<std::uint32_t> sleepers_{0};
+    std::atomic<int>           spin_{0};
+};
+
+} // namespace detail
+
+template <typename T>
+class drain_view;
+
+/** A bounded, lock-free queue for any number of producer and consumer
+    threads.
+
+    The elements live in a ring of slots, allocated once by the constructor,
+    each with a sequence number telling whether it is free or full in the
+    ring's current lap (D. Vyukov's bounded queue).  A producer claims a
+    free slot with a compare-and-swap on the shared write position, and a
+    consumer claims a full one with a compare-and-swap on the read position;
+    a `drain_view` claims a whole run of full slots with one.
+
+    `push()` waits while the queue is full, and `pop()` while it is empty:
+    both spin for a while, adaptively, before they sleep.  After `close()`,
+    pushes fail, and consumers get the elements pushed before it, and then
+    `std::nullopt` (or the end of their `drain_view`).  `T`'s move
+    constructor must not throw, so that a claimed slot is always filled. */
+template <typename T>
+    requires std::is_object_v<T> && std::is_nothrow_move_constructible_v<T>
+class mpmc_queue {
+  public:
+    using value_type = T;
+
+    /** Makes an empty queue with room for at least `capacity` elements. */
+    explicit mpmc_queue(std::size_t capacity)
+        : mask_(std::bit_ceil(std::max(capacity, std::size_t(2))) - 1),
+          slots_(std::make_unique<slot[]>(mask_ + 1)) {
+        for (std::size_t i = 0; i <= mask_; ++i)
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    mpmc_queue(const mpmc_queue&)            = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    ~mpmc_queue() {
+        const std::size_t last = enqueue_.load(std::memory_order_relaxed) &
+                                 ~closed_bit;
+        for (std::size_t pos = dequeue_.load(std::memory_order_relaxed);
+             pos != last;
+             ++pos)
+            std::destroy_at(&element(pos));
+    }
+
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    /** Moves `x` into the queue, if it is neither full nor closed.  Returns
+        whether it did; `x` is left alone if not. */
+    bool try_push(T&& x) noexcept {
+        std::size_t pos = enqueue_.load(std::memory_order_relaxed);
+        for (;;) {
+            if (pos & closed_bit)
+                return false;
+            const std::size_t seq =
+                slots_[pos & mask_].seq.load(std::memory_order_acquire);
+            if (seq == pos) {
+                if (enqueue_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (std::ptrdiff_t(seq - pos) < 0) {
+                return false; // Full: the slot still holds the last lap's.
+            } else {
+                pos = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+        slot& s = slots_[pos & mask_];
+        std::construct_at(reinterpret_cast<T*>(s.storage), std::move(x));
+        s.seq.store(pos + 1, std::memory_order_release);
+        not_empty_.notify();
+        return true;
+    }
+
+    bool try_push(const T& x)
+        requires std::copy_constructible<T>
+    {
+        T copy(x);
+        return try_push(std::move(copy));
+    }
+
+    /** Moves `x` into the queue, waiting while it is full.  Returns false,
+        leaving `x` alone, once the queue is closed. */
+    bool push(T&& x) noexcept {
+        bool pushed = false;
+        not_full_.wait_until([&] {
+            pushed = try_push(std::move(x));
+            return pushed || closed();
+        });
+        return pushed;
+    }
+
+    bool push(const T& x)
+        requires std::copy_constructible<T>
+    {
+        T copy(x);
+        return push(std::move(copy));
+    }
+
+    /** Removes the oldest element, if there is one that is ready. */
+    std::optional<T> try_pop() {
+        std::size_t pos = 0;
+        if (claim(1, pos) == 0)
+            return std::nullopt;
+        return take(pos);
+    }
+
+    /** Removes the oldest element, waiting while the queue is empty.
+        Returns `std::nullopt` once the queue is closed and empty. */
+    std::optional<T> pop() {
+        std::size_t pos = 0;
+        if (wait_claim(1, pos) == 0)
+            return std::nullopt;
+        return take(pos);
+    }
+
+    /** Makes every later push fail, and wakes the waiting threads.
+        Consumers still get the elements pushed before. */
+    void close() noexcept {
+        enqueue_.fetch_or(closed_bit, std::memory_order_release);
+        not_empty_.notify();
+        not_full_.notify();
+    }
+
+    bool closed() const noexcept {
+        return enqueue_.load(std::memory_order_acquire) & closed_bit;
+    }
+
+  private:
+    friend drain_view<T>;
+
+    static constexpr std::size_t closed_bit =
+        std::size_t(1) << (std::numeric_limits<std::size_t>::digits - 1);
+    static constexpr std::size_t line = 64;
+
+    // A slot is free for the push at position pos when seq == pos, and full
+    // for the pop at position pos when seq == pos + 1.
+    struct slot {
+        std::atomic<std::size_t> seq;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    T& element(std::size_t pos) noexcept {
+        return *std::launder(
+            reinterpret_cast<T*>(slots_[pos & mask_].storage));
+    }
+
+    // True iff the queue is closed, and every element pushed has been
+    // claimed by a consumer.
+    bool finished() const noexcept {
+        const std::size_t tail = enqueue_.load(std::memory_order_acquire);
+        return (tail & closed_bit) &&
+               dequeue_.load(std::memory_order_acquire) ==
+                   (tail & ~closed_bit);
+    }
+
+    // Claims the run of up to max (at most capacity()) full slots at the
+    // read position.  Returns their number, and the position of the first
+    // in first, or 0 if the oldest slot is not full.
+    std::size_t claim(std::size_t max, std::size_t& first) noexcept {
+        std::size_t pos = dequeue_.load(std::memory_order_relaxed);
+        for (;;) {
+            std::size_t n = 0;
+            while (n < max && slots_[(pos + n) & mask_].seq.load(
+                                  std::memory_order_acquire) == pos + n + 1)
+                ++n;
+            if (n == 0) {
+                const std::size_t now =
+                    dequeue_.load(std::memory_order_relaxed);
+                if (now == pos)
+                    return 0;
+                pos = now; // Another consumer got there first.
+            } else if (dequeue_.compare_exchange_weak(
+                           pos, pos + n, std::memory_order_relaxed)) {
+                first = pos;
+                return n;
+            }
+        }
+    }
+
+    // As claim(), but waits for a full slot; returns 0 only once the queue
+    // is finished.
+    std::size_t wait_claim(std::size_t max, std::size_t& first) noexcept {
+        std::size_t n = 0;
+        not_empty_.wait_until([&] {
+            n = claim(max, first);
+            return n != 0 || finished();
+        });
+        return n;
+    }
+
+    // Destroys the element in the claimed slot at pos, and frees the slot
+    // for the next lap's push.  The caller notifies not_full_.
+    void release(std::size_t pos) noexcept {
+        std::destroy_at(&element(pos));
+        slots_[pos & mask_].seq.store(pos + mask_ + 1,
+                                      std::memory_order_release);
+    }
+
+    std::optional<T> take(std::size_t pos) noexcept {
+        std::optional<T> x(std::move(element(pos)));
+        release(pos);
+        not_full_.notify();
+        return x;
+    }
+
+    std::size_t             mask_;
+    std::unique_ptr<slot[]> slots_;
+
+    alignas(line) std::atomic<std::size_t> enqueue_{0};
+    alignas(line) std::atomic<std::size_t> dequeue_{0};
+    alignas(line) detail::event_count not_empty_;
+    alignas(line) detail::event_count not_full_;
+};
+
+/** An input view of the elements popped from an `mpmc_queue`, until the
+    queue is closed and empty.
+
+    The view claims up to `batch` ready elements at a time, with a single
+    compare-and-swap, and its iterator refers to each of them in place, in
+    its queue slot: `*it` does not pop anything, so it may be evaluated any
+    number of times, and `++it` destroys the element and frees its slot.
+    Each element is seen by exactly one of the queue's consumers.  So
+    `views::drain(q) | views::transform(f)` runs `f` on each element of the
+    queue once per dereference, without copying it or allocating.
+
+    When no element is ready, the view waits as `pop()` does.  Destroying
+    the view before its end destroys the elements it has claimed but not
+    yet reached, at most `batch - 1` of them. */
+template <typename T>
+class drain_view : public std::ranges::view_interface<drain_view<T> > {
+    class iterator {
+      public:
+        using value_type      = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        T& operator*() const noexcept {
+            return parent_->queue_->element(parent_->next_);
+        }
+
+        iterator& operator++() {
+            parent_->advance();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) {
+            return it.at_end();
+        }
+
+      private:
+        friend drain_view;
+
+        explicit iterator(drain_view* parent) : parent_(parent) {}
+
+        bool at_end() const noexcept {
+            return parent_->next_ == parent_->end_;
+        }
+
+        drain_view* parent_ = nullptr;
+    };
+
+  public:
+    /** Consumes from `q`, which must outlive the view.  Nothing is popped
+        until `begin()`. */
+    explicit drain_view(mpmc_queue<T>& q, std::size_t batch = drain_batch)
+        : queue_(std::addressof(q)),
+          batch_(std::clamp(batch, std::size_t(1), q.capacity())) {}
+
+    drain_view(drain_view&& other) noexcept
+        : queue_(other.queue_),
+          batch_(other.batch_),
+          next_(other.next_),
+          end_(std::exchange(other.end_, other.next_)) {}
+
+    drain_view& operator=(drain_view&& other) noexcept {
+        if (this != &other) {
+            discard();
+            queue_ = other.queue_;
+            batch_ = other.batch_;
+            next_  = other.next_;
+            end_   = std::exchange(other.end_, other.next_);
+        }
+        return *this;
+    }
+
+    ~drain_view() { discard(); }
+
+    /** Waits for the first element, and returns an iterator to it, or to the
+        end if the queue is closed and empty. */
+    iterator begin() {
+        if (next_ == end_)
+            fill();
+        return iterator(this);
+    }
+
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+  private:
+    void fill() {
+        next_ = 0;
+        end_  = queue_->wait_claim(batch_, next_);
+        end_ += next_;
+    }
+
+    void advance() {
+        queue_->release(next_);
+        if (++next_ == end_) {
+            queue_->not_full_.notify();
+            fill();
+        }
+    }
+
+    void discard() noexcept {
+        if (next_ == end_)
+            return;
+        for (; next_ != end_; ++next_)
+            queue_->release(next_);
+        queue_->not_full_.notify();
+    }
+
+    mpmc_queue<T>* queue_;
+    std::size_t    batch_;
+    std::size_t    next_ = 0; // The claimed slots are [next_, end_).
+    std::size_t    end_  = 0;
+};
+
+namespace views {
+
+namespace detail {
+
+struct drain_fn {
+    template <typename T>
+    drain_view<T> operator() [[nodiscard]] (
+        mpmc_queue<T>& q, std::size_t batch = drain_batch) const {
+        return drain_view<T>(q, batch);
+    }
+};
+
+} // namespace detail
+
+/** Returns a `drain_view` of `q`, which pops its elements until it is
+    closed and empty. */
+inline constexpr detail::drain_fn drain;
+
+} // namespace views
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_MPMC_QUEUE_HPP
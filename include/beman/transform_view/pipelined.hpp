@@ -0,0 +1,473 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_PIPELINED_HPP
+#define BEMAN_TRANSFORM_VIEW_PIPELINED_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#endif
+
+namespace beman::transform_view {
+
+/** The default number of elements `views::pipelined` moves between stages
+    at a time. */
+inline constexpr std::size_t pipeline_batch = 64;
+
+namespace detail {
+
+// Set in a ring index once its owner is done with the ring.
+inline constexpr std::size_t ring_closed =
+    std::size_t(1) << (std::numeric_limits<std::size_t>::digits - 1);
+
+// Waits until a no longer holds old, spinning briefly before blocking.
+inline void wait_for_change(const std::atomic<std::size_t>& a,
+                            std::size_t                     old) noexcept {
+    for (int i = 0; i < 64; ++i) {
+        if (a.load(std::memory_order_acquire) != old)
+            return;
+        std::this_thread::yield();
+    }
+    a.wait(old, std::memory_order_acquire);
+}
+
+// A bounded single-producer, single-consumer queue.  Each side works on
+// private copies of the indices, and publishes its own index only once per
+// batch, or before it waits for the other side, so that the two threads
+// exchange cache lines once per batch rather than once per element.
+//
+// The consumer may cancel the ring, and the producer may close it; either
+// sets ring_closed in the index the other side reads.  cancel() may also be
+// called by a thread other than the consumer, to stop the producer early.
+template <typename T>
+class spsc_ring {
+  public:
+    spsc_ring(std::size_t capacity, std::size_t batch)
+        : slots_(std::make_unique<std::optional<T>[]>(capacity)),
+          mask_(capacity - 1),
+          batch_(batch) {}
+
+    // Producer side.
+
+    // Appends the value of x, waiting for room if the ring is full.  Returns
+    // false without appending anything once the ring has been cancelled.
+    template <typename U>
+    bool push(U&& x) {
+        if (write_ - head_seen_ > mask_ ||
+            (head_.load(std::memory_order_relaxed) & ring_closed)) {
+            if (!wait_for_room())
+                return false;
+        }
+        slots_[write_ & mask_].emplace((U&&)x);
+        if (++write_ - write_published_ >= batch_)
+            flush();
+        return true;
+    }
+
+    // Makes everything appended so far visible to the consumer.
+    void flush() noexcept {
+        if (write_published_ != write_) {
+            write_published_ = write_;
+            tail_.store(write_, std::memory_order_release);
+            tail_.notify_one();
+        }
+    }
+
+    // Makes everything appended so far visible to the consumer, and tells it
+    // that nothing more will be.
+    void close() noexcept {
+        write_published_ = write_;
+        tail_.store(write_ | ring_closed, std::memory_order_release);
+        tail_.notify_one();
+    }
+
+    // Consumer side.
+
+    // True iff front() would return without waiting.
+    bool ready() noexcept {
+        if (read_ != tail_seen_)
+            return true;
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        tail_seen_             = tail & ~ring_closed;
+        return read_ != tail_seen_ || (tail & ring_closed);
+    }
+
+    // Returns the oldest element, waiting for one if there is none, or
+    // nullptr if the ring is closed and empty.
+    T* front() {
+        while (read_ == tail_seen_) {
+            const std::size_t tail = tail_.load(std::memory_order_acquire);
+            tail_seen_             = tail & ~ring_closed;
+            if (read_ != tail_seen_)
+                break;
+            if (tail & ring_closed)
+                return nullptr;
+            release();
+            detail::wait_for_change(tail_, tail);
+        }
+        return &*slots_[read_ & mask_];
+    }
+
+    // Removes the oldest element.
+    void pop() noexcept {
+        slots_[read_ & mask_].reset();
+        if (++read_ - read_published_ >= batch_)
+            release();
+    }
+
+    // Tells the producer that nothing more will be popped.
+    void cancel() noexcept {
+        head_.fetch_or(ring_closed, std::memory_order_release);
+        head_.notify_one();
+    }
+
+  private:
+    // Returns once the ring has room, or with false once it is cancelled.
+    bool wait_for_room() {
+        for (;;) {
+            const std::size_t head = head_.load(std::memory_order_acquire);
+            if (head & ring_closed)
+                return false;
+            head_seen_ = head;
+            if (write_ - head_seen_ <= mask_)
+                return true;
+            flush();
+            detail::wait_for_change(head_, head);
+        }
+    }
+
+    // Makes the slots popped so far available to the producer.  An add
+    // rather than a store, so that it does not clear ring_closed.
+    void release() noexcept {
+        if (read_published_ != read_) {
+            head_.fetch_add(read_ - read_published_, std::memory_order_release);
+            read_published_ = read_;
+            head_.notify_one();
+        }
+    }
+
+    static constexpr std::size_t line = 64;
+
+    std::unique_ptr<std::optional<T>[]> slots_;
+    std::size_t                         mask_;
+    std::size_t                         batch_;
+
+    alignas(line) std::atomic<std::size_t> head_{0};
+    alignas(line) std::atomic<std::size_t> tail_{0};
+
+    // The producer's view of the indices.
+    alignas(line) std::size_t write_ = 0;
+    std::size_t               write_published_ = 0;
+    std::size_t               head_seen_       = 0;
+
+    // The consumer's view of the indices.
+    alignas(line) std::size_t read_ = 0;
+    std::size_t               read_published_ = 0;
+    std::size_t               tail_seen_      = 0;
+};
+
+template <typename R>
+inline constexpr bool is_pipeline_stage =
+    transform_view_traits<R>::is_transform_view;
+
+template <typename R>
+class pipeline_node;
+
+template <typename V>
+struct pipeline_input {
+    using type = std::ranges::range_reference_t<V>;
+};
+template <typename V>
+    requires is_pipeline_stage<V>
+struct pipeline_input<V> {
+    using type = typename pipeline_node<V>::value_type&&;
+};
+
+// One stage of a pipelined_view: a thread that applies the callable of a
+// transform_view<V, F> to the elements of V, and appends the results to a
+// ring.  If V is itself a transform_view, its elements come from the ring of
+// another node, which runs V's stage; otherwise this thread iterates V.
+template <typename V, typename F>
+class pipeline_node<transform_view<V, F> > {
+    static constexpr bool chained = is_pipeline_stage<V>;
+
+    using input    = typename pipeline_input<V>::type;
+    using upstream = std::conditional_t<chained, pipeline_node<V>, V>;
+
+  public:
+    using value_type = std::remove_cvref_t<std::invoke_result_t<F&, input> >;
+
+    pipeline_node(transform_view<V, F> view, std::size_t batch)
+        : f_(std::move(view_access::fun(view))),
+          up_(make_upstream(std::move(view).base(), batch)),
+          ring_(std::bit_ceil(8 * batch), batch) {}
+
+    pipeline_node(const pipeline_node&)            = delete;
+    pipeline_node& operator=(const pipeline_node&) = delete;
+
+    ~pipeline_node() { stop(); }
+
+    // Starts the threads of this stage and of the ones before it.
+    void start() {
+        if constexpr (chained)
+            up_.start();
+        thread_ = std::thread([this] { run(); });
+    }
+
+    // Tells this stage and the ones before it to stop.
+    void cancel() noexcept {
+        ring_.cancel();
+        if constexpr (chained)
+            up_.cancel();
+    }
+
+    // Stops this stage and the ones before it, and waits for their threads.
+    void stop() noexcept {
+        cancel();
+        if (thread_.joinable())
+            thread_.join();
+        if constexpr (chained)
+            up_.stop();
+    }
+
+    spsc_ring<value_type>& ring() noexcept { return ring_; }
+
+    // Returns the next result, or nullptr at the end.  If a stage failed,
+    // its exception is rethrown at the end instead.
+    value_type* next() {
+        value_type* x = ring_.front();
+        if (x == nullptr)
+            rethrow();
+        return x;
+    }
+
+  private:
+    static upstream make_upstream(V base, std::size_t batch) {
+        if constexpr (chained)
+            return upstream(std::move(base), batch);
+        else
+            return base;
+    }
+
+    void run() noexcept {
+        try {
+            if constexpr (chained) {
+                auto& in = up_.ring();
+                for (;;) {
+                    // Hand on what is done before waiting for more.
+                    if (!in.ready())
+                        ring_.flush();
+                    auto* x = in.front();
+                    if (x == nullptr ||
+                        !ring_.push(std::invoke(f_, std::move(*x))))
+                        break;
+                    in.pop();
+                }
+            } else {
+                for (auto&& x : up_) {
+                    if (!ring_.push(std::invoke(f_, (decltype(x)&&)x)))
+                        break;
+                }
+            }
+        } catch (...) {
+            error_ = std::current_exception();
+        }
+        if constexpr (chained)
+            up_.ring().cancel();
+        ring_.close();
+    }
+
+    // Called once ring_ is closed, after which this stage's thread no longer
+    // touches error_.  The stages before it may still be running, though --
+    // an exception here cancels them mid-element -- so they are stopped
+    // before their errors are read.
+    void rethrow() {
+        if constexpr (chained) {
+            up_.stop();
+            up_.rethrow();
+        }
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+
+    template <typename>
+    friend class pipeline_node;
+
+    F                     f_;
+    upstream              up_;
+    spsc_ring<value_type> ring_;
+    std::exception_ptr    error_;
+    std::thread           thread_;
+};
+
+template <typename V, typename F>
+constexpr bool can_pipeline_stage() {
+    using input = typename pipeline_input<V>::type;
+    if constexpr (std::invocable<F&, input>)
+        return std::move_constructible<F> &&
+               std::constructible_from<
+                   std::remove_cvref_t<std::invoke_result_t<F&, input> >,
+                   std::invoke_result_t<F&, input> >;
+    else
+        return false;
+}
+
+template <typename R>
+constexpr bool can_pipeline() {
+    if constexpr (!is_pipeline_stage<R>) {
+        return false;
+    } else {
+        using V = typename transform_view_traits<R>::base_type;
+        using F = typename transform_view_traits<R>::func_type;
+        if constexpr (is_pipeline_stage<V>) {
+            if constexpr (detail::can_pipeline<V>())
+                return detail::can_pipeline_stage<V, F>();
+            else
+                return false;
+        } else {
+            return detail::can_pipeline_stage<V, F>();
+        }
+    }
+}
+
+// True iff R is a chain of transform_views whose stages can each run on a
+// thread of their own.
+template <typename R>
+concept pipelinable = std::move_constructible<R> && detail::can_pipeline<R>();
+
+} // namespace detail
+
+/** An input view of the elements of `R`, a `transform_view` or a chain of
+    nested `transform_view`s, in which each transform runs on a thread of its
+    own.
+
+    The first stage's thread iterates the innermost underlying view, and
+    each stage's results are handed to the next stage's thread -- and the
+    last one's to the thread iterating this view -- through a bounded,
+    lock-free single-producer, single-consumer ring, `batch` elements at a
+    time.  So a chain of N expensive transforms over a single-pass input
+    (e.g. decode, then parse, then enrich) keeps up to N cores busy, while
+    the elements still come out in order.  Each element is a
+    `std::remove_cvref_t` of its transform's result, and each stage receives
+    the previous stage's result as an rvalue.
+
+    The threads start on the first call to `begin()`.  A stage whose ring is
+    full waits for the next stage (backpressure).  If a transform throws, the
+    results before it are still delivered, and then the exception is
+    rethrown from the increment that reaches the end, once every stage has
+    stopped; if several stages threw, the earliest stage's exception wins.
+    Destroying the view before the end stops every stage at its next
+    element and joins the threads; this can only wait for the transforms and
+    the read of the underlying view that are already in progress.
+
+    The callables and the underlying view are used on other threads than
+    the one iterating the view, and a stage publishes its results only once
+    per `batch`, or when it has to wait for its input; with a slow source,
+    a small `batch` keeps latency down. */
+template <typename R>
+    requires detail::pipelinable<R>
+class pipelined_view : public std::ranges::view_interface<pipelined_view<R> > {
+    using node       = detail::pipeline_node<R>;
+    using value_type = typename node::value_type;
+
+    class iterator {
+      public:
+        using value_type      = pipelined_view::value_type;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        value_type& operator*() const noexcept { return *current_; }
+
+        iterator& operator++() {
+            node_->ring().pop();
+            current_ = node_->next();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) {
+            return it.current_ == nullptr;
+        }
+
+      private:
+        friend pipelined_view;
+
+        explicit iterator(node* n) : node_(n), current_(n->next()) {}
+
+        node*       node_    = nullptr;
+        value_type* current_ = nullptr;
+    };
+
+  public:
+    /** Takes ownership of `r`; nothing runs until `begin()`. */
+    explicit pipelined_view(R r, std::size_t batch = pipeline_batch)
+        : node_(std::make_unique<node>(
+              std::move(r), batch == 0 ? std::size_t(1) : batch)) {}
+
+    /** Starts the stages, and returns an iterator to the first element.
+        Must be called at most once. */
+    iterator begin() {
+        node_->start();
+        return iterator(node_.get());
+    }
+
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+  private:
+    std::unique_ptr<node> node_;
+};
+
+namespace views {
+
+namespace detail {
+
+struct pipelined_impl {
+    template <std::ranges::viewable_range Range>
+        requires beman::transform_view::detail::pipelinable<
+            std::views::all_t<Range> >
+    auto operator() [[nodiscard]] (Range&&    r,
+                                   std::size_t batch = pipeline_batch) const {
+        return pipelined_view<std::views::all_t<Range> >(
+            std::views::all((Range&&)r), batch);
+    }
+};
+
+} // namespace detail
+
+/** Returns a `pipelined_view` of a chain of `transform_view`s, which runs
+    each transform on a thread of its own. */
+inline constexpr detail::adaptor<detail::pipelined_impl> pipelined =
+    detail::pipelined_impl{};
+
+} // namespace views
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_PIPELINED_HPP
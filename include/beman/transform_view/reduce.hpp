@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_REDUCE_HPP
+#define BEMAN_TRANSFORM_VIEW_REDUCE_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/batch.hpp>
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <utility>
+#endif
+
+namespace beman::transform_view {
+
+/** Tag type used to select the unordered overloads of `reduce()`. */
+struct unordered_t {
+    explicit unordered_t() = default;
+};
+
+/** Tag used to select the unordered overloads of `reduce()`. */
+inline constexpr unordered_t unordered{};
+
+namespace detail {
+
+// Returns a callable that produces the n-th element of r, given r's
+// beginning.  For a transform_view with a tidy F, this indexes the base
+// iterator and constructs F directly, so the unrolled loops below never go
+// through the iterator's parent_ pointer.
+template <typename R>
+constexpr bool has_tidy_func() {
+    using traits = transform_view_traits<std::remove_const_t<R> >;
+    if constexpr (traits::is_transform_view)
+        return tidy_func<typename traits::func_type>;
+    else
+        return false;
+}
+
+template <typename R>
+constexpr auto indexed_access(R& r) {
+    auto first = std::ranges::begin(r);
+    using traits = transform_view_traits<std::remove_const_t<R> >;
+    if constexpr (detail::has_tidy_func<R>()) {
+        using F = typename traits::func_type;
+        return [base = std::move(first).base()](
+                   std::ranges::range_difference_t<R> n) -> decltype(auto) {
+            return std::invoke(F(), base[n]);
+        };
+    } else {
+        return [first = std::move(first)](
+                   std::ranges::range_difference_t<R> n) -> decltype(auto) {
+            return first[n];
+        };
+    }
+}
+
+// Returns values as a range of rvalues, so that folding over a batch passes
+// op the same value category as folding over the view would.
+template <typename T>
+constexpr auto as_rvalues(std::span<T> values) {
+    return std::ranges::subrange(std::make_move_iterator(values.begin()),
+                                 std::make_move_iterator(values.end()));
+}
+
+template <typename R>
+concept unrollable_range =
+    std::ranges::random_access_range<R> && std::ranges::sized_range<R>;
+
+template <typename R, typename T, typename Op>
+concept foldable_range =
+    std::ranges::input_range<R> && std::movable<T> &&
+    std::invocable<Op&, T, std::ranges::range_reference_t<R> > &&
+    std::assignable_from<
+        T&,
+        std::invoke_result_t<Op&, T, std::ranges::range_reference_t<R> > >;
+
+} // namespace detail
+
+/** Returns the left fold of `op` over `r`, starting from `init`; the result
+    is the same as that of `std::ranges::fold_left(r, init, op)`.
+
+    When `r` is a sized random-access range, its elements are produced `K`
+    at a time -- for a transform_view with a tidy `F`, by calling `F`
+    directly on the underlying elements -- so that the evaluations of
+    consecutive elements do not depend on one another.  The calls to `op`
+    still happen one after another, in order.  A `transform_view` whose
+    callable is `batch_invocable` (see `batch_copy()`) is instead evaluated
+    a batch at a time, and each batch is folded as above.  A chunked view
+    (see `batch_copy()`) is folded a chunk at a time. */
+template <std::size_t K = 4,
+          std::ranges::input_range R,
+          typename T,
+          typename Op = std::plus<> >
+    requires(0 < K) && detail::foldable_range<R, T, Op>
+constexpr T reduce(R&& r, T init, Op op = Op()) {
+    T acc = std::move(init);
+    if constexpr (detail::chunked_range<R>) {
+        detail::for_each_chunk(r, [&](auto chunk) {
+            acc = beman::transform_view::reduce<K>(
+                chunk, std::move(acc), std::ref(op));
+        });
+    } else if constexpr (detail::batch_view<R>) {
+        using Out = std::ranges::range_value_t<R>;
+        detail::for_each_batch(r, [&](std::span<Out> values) {
+            acc = beman::transform_view::reduce<K>(
+                detail::as_rvalues(values), std::move(acc), std::ref(op));
+        });
+    } else if constexpr (detail::unrollable_range<R>) {
+        using diff_t = std::ranges::range_difference_t<R>;
+
+        auto         at = detail::indexed_access(r);
+        const diff_t n  = std::ranges::distance(r);
+        diff_t       i  = 0;
+        for (; K <= std::size_t(n - i); i += diff_t(K)) {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                std::tuple<decltype(at(i + diff_t(I)))...> values{
+                    at(i + diff_t(I))...};
+                ((acc = std::invoke(
+                      op, std::move(acc), std::get<I>(std::move(values)))),
+                 ...);
+            }(std::make_index_sequence<K>{});
+        }
+        for (; i < n; ++i)
+            acc = std::invoke(op, std::move(acc), at(i));
+    } else {
+        for (auto&& x : r)
+            acc = std::invoke(op, std::move(acc), (decltype(x)&&)x);
+    }
+    return acc;
+}
+
+/** Like the ordered `reduce()`, except that `op` is assumed to be
+    associative and commutative, so the elements of `r` may be combined in
+    any order.
+
+    When `r` is a sized random-access range, the elements are accumulated
+    into `K` independent accumulators, which are then combined with `op`.
+    This breaks the serial dependency through a single accumulator, and so
+    lets e.g. floating-point sums pipeline and vectorize without
+    `-ffast-math`.  The result may differ from that of the ordered
+    `reduce()` by rounding. */
+template <std::size_t K = 4,
+          std::ranges::input_range R,
+          typename T,
+          typename Op = std::plus<> >
+    requires(0 < K) && detail::foldable_range<R, T, Op> &&
+            std::invocable<Op&, T, T> &&
+            std::assignable_from<T&, std::invoke_result_t<Op&, T, T> >
+constexpr T reduce(unordered_t, R&& r, T init, Op op = Op()) {
+    using reference = std::ranges::range_reference_t<R>;
+    if constexpr (detail::chunked_range<R>) {
+        T acc = std::move(init);
+        detail::for_each_chunk(r, [&](auto chunk) {
+            acc = beman::transform_view::reduce<K>(
+                unordered, chunk, std::move(acc), std::ref(op));
+        });
+        return acc;
+    } else if constexpr (detail::batch_view<R>) {
+        using Out = std::ranges::range_value_t<R>;
+        T acc     = std::move(init);
+        detail::for_each_batch(r, [&](std::span<Out> values) {
+            acc = beman::transform_view::reduce<K>(unordered,
+                                                   detail::as_rvalues(values),
+                                                   std::move(acc),
+                                                   std::ref(op));
+        });
+        return acc;
+    } else if constexpr (detail::unrollable_range<R> &&
+                  std::constructible_from<T, reference>) {
+        using diff_t = std::ranges::range_difference_t<R>;
+
+        auto         at = detail::indexed_access(r);
+        const diff_t n  = std::ranges::distance(r);
+        if (n < diff_t(K))
+            return beman::transform_view::reduce<1>(r, std::move(init), op);
+
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+            std::array<T, K> accs{T(at(diff_t(I)))...};
+            diff_t           i = diff_t(K);
+            for (; K <= std::size_t(n - i); i += diff_t(K)) {
+                ((accs[I] = std::invoke(
+                      op, std::move(accs[I]), at(i + diff_t(I)))),
+                 ...);
+            }
+            for (std::size_t j = 0; i < n; ++i, ++j)
+                accs[j] = std::invoke(op, std::move(accs[j]), at(i));
+            T acc = std::move(init);
+            ((acc = std::invoke(op, std::move(acc), std::move(accs[I]))),
+             ...);
+            return acc;
+        }(std::make_index_sequence<K>{});
+    } else {
+        return beman::transform_view::reduce<K>(r, std::move(init), op);
+    }
+}
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_REDUCE_HPP
@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_SORT_BY_CACHED_KEY_HPP
+#define BEMAN_TRANSFORM_VIEW_SORT_BY_CACHED_KEY_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#endif
+
+namespace beman::transform_view {
+
+namespace detail {
+
+enum class cached_key_sort { unstable, stable, partial };
+
+template <typename R, typename F>
+using cached_key_t = std::remove_cvref_t<
+    std::invoke_result_t<F&, std::ranges::range_reference_t<R> > >;
+
+template <typename R, typename F, typename Comp>
+concept cached_key_sortable =
+    std::ranges::random_access_range<R> && std::ranges::sized_range<R> &&
+    std::permutable<std::ranges::iterator_t<R> > &&
+    std::move_constructible<F> && std::is_object_v<F> &&
+    std::regular_invocable<F&, std::ranges::range_reference_t<R> > &&
+    std::movable<cached_key_t<R, F> > &&
+    std::indirect_strict_weak_order<Comp, const cached_key_t<R, F>*>;
+
+// Moves the elements of [first, first + perm.size()) so that the element
+// that was at first + perm[i] ends up at first + i.  perm is consumed.
+template <std::random_access_iterator I, typename Index>
+constexpr void apply_permutation(I first, std::vector<Index>& perm) {
+    using diff_t = std::iter_difference_t<I>;
+    for (std::size_t i = 0; i < perm.size(); ++i) {
+        if (perm[i] == Index(i))
+            continue;
+        std::iter_value_t<I> tmp = std::ranges::iter_move(first + diff_t(i));
+        std::size_t          j   = i;
+        while (std::size_t(perm[j]) != i) {
+            const std::size_t k  = perm[j];
+            *(first + diff_t(j)) = std::ranges::iter_move(first + diff_t(k));
+            perm[j]              = Index(j);
+            j                    = k;
+        }
+        *(first + diff_t(j)) = std::move(tmp);
+        perm[j]              = Index(j);
+    }
+}
+
+template <typename Index,
+          cached_key_sort Kind,
+          typename R,
+          typename F,
+          typename Comp>
+constexpr void
+sort_by_cached_key_impl(R& r, std::size_t middle, F& f, Comp& comp) {
+    using key_type   = cached_key_t<R, F>;
+    using entry_type = std::pair<key_type, Index>;
+
+    auto first = std::ranges::begin(r);
+    auto all   = std::ranges::subrange(first, first + std::ranges::distance(r));
+
+    std::vector<entry_type> cache;
+    cache.reserve(std::ranges::size(all));
+    auto fill = [&cache](auto keys) {
+        Index index = 0;
+        for (auto&& key : keys)
+            cache.emplace_back((decltype(key)&&)key, index++);
+    };
+    if constexpr (tidy_func<F>)
+        fill(beman::transform_view::transform_view(all, F()));
+    else
+        fill(beman::transform_view::transform_view(all, std::ref(f)));
+
+    auto proj = [](const entry_type& e) -> const key_type& { return e.first; };
+    if constexpr (Kind == cached_key_sort::unstable) {
+        std::ranges::sort(cache, std::ref(comp), proj);
+    } else if constexpr (Kind == cached_key_sort::stable) {
+        std::ranges::stable_sort(cache, std::ref(comp), proj);
+    } else {
+        std::ranges::partial_sort(cache,
+                                  cache.begin() + std::ptrdiff_t(middle),
+                                  std::ref(comp),
+                                  proj);
+    }
+
+    std::vector<Index> perm;
+    perm.reserve(cache.size());
+    for (auto& e : cache)
+        perm.push_back(e.second);
+    cache = std::vector<entry_type>();
+
+    detail::apply_permutation(first, perm);
+}
+
+template <cached_key_sort Kind, typename R, typename F, typename Comp>
+constexpr std::ranges::borrowed_iterator_t<R>
+sort_by_cached_key_dispatch(R&& r, std::size_t middle, F& f, Comp& comp) {
+    const auto n = std::size_t(std::ranges::size(r));
+    if (n <= std::size_t((std::numeric_limits<std::uint32_t>::max)())) {
+        detail::sort_by_cached_key_impl<std::uint32_t, Kind>(
+            r, middle, f, comp);
+    } else {
+        detail::sort_by_cached_key_impl<std::size_t, Kind>(r, middle, f, comp);
+    }
+    return std::ranges::next(std::ranges::begin(r), std::ranges::end(r));
+}
+
+} // namespace detail
+
+/** Sorts `r` by the keys `f(x)` of its elements `x`, compared with `comp`,
+    calling `f` exactly once per element.
+
+    The keys are computed through a `transform_view` of `r` and `f` --
+    without copying `f`, or, when `f` is tidy, without using it at all -- and
+    cached in a contiguous buffer along with the original positions of their
+    elements.  That buffer is sorted, and then `r` is permuted in place to
+    match, moving each element at most once.  This is preferable to
+    `std::ranges::sort(r, comp, f)` when `f` is expensive, since that
+    evaluates `f` O(N log N) times.  Returns an iterator equal to
+    `std::ranges::end(r)`. */
+template <std::ranges::random_access_range R,
+          typename F,
+          typename Comp = std::ranges::less>
+    requires detail::cached_key_sortable<R, F, Comp>
+constexpr std::ranges::borrowed_iterator_t<R>
+sort_by_cached_key(R&& r, F f, Comp comp = Comp()) {
+    return detail::sort_by_cached_key_dispatch<
+        detail::cached_key_sort::unstable>((R&&)r, 0, f, comp);
+}
+
+/** Like `sort_by_cached_key()`, except that elements with equivalent keys
+    keep their relative order. */
+template <std::ranges::random_access_range R,
+          typename F,
+          typename Comp = std::ranges::less>
+    requires detail::cached_key_sortable<R, F, Comp>
+constexpr std::ranges::borrowed_iterator_t<R>
+stable_sort_by_cached_key(R&& r, F f, Comp comp = Comp()) {
+    return detail::sort_by_cached_key_dispatch<
+        detail::cached_key_sort::stable>((R&&)r, 0, f, comp);
+}
+
+/** Like `sort_by_cached_key()`, except that only [`begin(r)`, `middle`) is
+    sorted, as with `std::ranges::partial_sort()`.  The keys of all elements
+    are still computed, exactly once each. */
+template <std::ranges::random_access_range R,
+          typename F,
+          typename Comp = std::ranges::less>
+    requires detail::cached_key_sortable<R, F, Comp>
+constexpr std::ranges::borrowed_iterator_t<R>
+partial_sort_by_cached_key(R&&                        r,
+                           std::ranges::iterator_t<R> middle,
+                           F                          f,
+                           Comp                       comp = Comp()) {
+    const auto m = std::size_t(middle - std::ranges::begin(r));
+    return detail::sort_by_cached_key_dispatch<
+        detail::cached_key_sort::partial>((R&&)r, m, f, comp);
+}
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_SORT_BY_CACHED_KEY_HPP
@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_SPLIT_HPP
+#define BEMAN_TRANSFORM_VIEW_SPLIT_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+#endif
+
+namespace beman::transform_view {
+
+namespace detail {
+
+template <typename R>
+concept splittable_base =
+    std::ranges::random_access_range<R> && std::ranges::sized_range<R>;
+
+// Returns [first, last) as a view: as the original view type V if V can be
+// constructed from an iterator pair (as std::span, std::string_view and
+// std::ranges::subrange can), otherwise as a std::span if the iterators are
+// contiguous, otherwise as a std::ranges::subrange.
+template <typename V, std::random_access_iterator I>
+constexpr auto make_sub_base(I first, I last) {
+    if constexpr (std::same_as<I, std::ranges::iterator_t<V> > &&
+                  std::constructible_from<V, I, I>) {
+        return V(std::move(first), std::move(last));
+    } else if constexpr (std::contiguous_iterator<I>) {
+        using T = std::remove_reference_t<std::iter_reference_t<I> >;
+        return std::span<T>(std::to_address(first), std::size_t(last - first));
+    } else {
+        return std::ranges::subrange<I>(std::move(first), std::move(last));
+    }
+}
+
+template <typename R>
+constexpr auto sub_range(R& r,
+                         std::ranges::range_difference_t<R> from,
+                         std::ranges::range_difference_t<R> to) {
+    using traits = transform_view_traits<std::remove_const_t<R> >;
+    if constexpr (traits::is_transform_view) {
+        using V     = typename traits::base_type;
+        using F     = typename traits::func_type;
+        auto  first = std::ranges::begin(r).base();
+        auto  base  = detail::make_sub_base<V>(first + from, first + to);
+        if constexpr (tidy_func<F>) {
+            return beman::transform_view::transform_view(std::move(base), F());
+        } else {
+            return beman::transform_view::transform_view(
+                std::move(base), view_access::fun(r));
+        }
+    } else {
+        auto first = std::ranges::begin(r);
+        return detail::make_sub_base<std::remove_const_t<R> >(first + from,
+                                                               first + to);
+    }
+}
+
+template <typename R>
+concept has_member_split_at =
+    requires(R&& r, std::ranges::range_difference_t<R> i) {
+        ((R&&)r).split_at(i);
+    };
+
+void split_at(); // poison pill
+
+template <typename R>
+concept has_adl_split_at =
+    requires(R&& r, std::ranges::range_difference_t<R> i) {
+        split_at((R&&)r, i);
+    };
+
+// The halves of a transform_view refer to the elements of its base, so the
+// base must outlive them; the halves of any other view refer to its
+// elements.
+template <typename R,
+          bool = transform_view_traits<
+              std::remove_cvref_t<R> >::is_transform_view>
+constexpr bool halves_can_outlive = std::ranges::borrowed_range<R>;
+
+template <typename R>
+constexpr bool halves_can_outlive<R, true> =
+    std::ranges::borrowed_range<
+        typename transform_view_traits<std::remove_cvref_t<R> >::base_type> ||
+    std::is_lvalue_reference_v<R>;
+
+// Each half of a transform_view gets a copy of its callable, unless the
+// callable is tidy.
+template <typename R,
+          bool = transform_view_traits<
+              std::remove_cvref_t<R> >::is_transform_view>
+constexpr bool halves_can_get_func = true;
+
+template <typename R>
+constexpr bool halves_can_get_func<R, true> =
+    tidy_func<typename transform_view_traits<
+        std::remove_cvref_t<R> >::func_type> ||
+    std::copy_constructible<
+        typename transform_view_traits<std::remove_cvref_t<R> >::func_type>;
+
+template <typename R>
+concept has_default_split_at = std::ranges::view<std::remove_cvref_t<R> > &&
+                               splittable_base<R> && halves_can_outlive<R> &&
+                               halves_can_get_func<R>;
+
+struct split_at_fn {
+    template <std::ranges::range R>
+        requires has_member_split_at<R> || has_adl_split_at<R> ||
+                 has_default_split_at<R>
+    constexpr auto
+    operator()(R&& r, std::ranges::range_difference_t<R> i) const {
+        if constexpr (has_member_split_at<R>) {
+            return ((R&&)r).split_at(i);
+        } else if constexpr (has_adl_split_at<R>) {
+            return split_at((R&&)r, i);
+        } else {
+            const auto n = std::ranges::range_difference_t<R>(
+                std::ranges::distance(r));
+            return std::pair(detail::sub_range(r, 0, i),
+                             detail::sub_range(r, i, n));
+        }
+    }
+};
+
+} // namespace detail
+
+/** Splits `r` into two subranges, [0, `i`) and [`i`, `size(r)`), and returns
+    them as a `std::pair`.
+
+    A type can customize this with a member `r.split_at(i)`, or a free
+    function `split_at(r, i)` found by ADL.  Otherwise, `r` must be a sized,
+    random-access view.  If `r` is a `transform_view<V, F>`, both halves are
+    `transform_view`s with a copy of `F` (or a new `F`, if `F` is tidy), over
+    halves of `V`; those are of type `V` if `V` can be constructed from a pair
+    of its iterators, `std::span`s if `V` is contiguous, and
+    `std::ranges::subrange`s otherwise.  In particular, the halves have the
+    same type as `r` when `V` is e.g. a `std::span`, and are borrowed ranges
+    whenever `F` is tidy.  `F` must be copy constructible unless it is
+    tidy.  The halves refer to the elements of `V`, so if `V` is
+    not a borrowed range, `r` must be an lvalue.  Other views are split the
+    same way, minus the transform; they must be borrowed ranges.
+
+    \pre `0 <= i && i <= std::ranges::distance(r)` */
+inline constexpr detail::split_at_fn split_at;
+
+namespace detail {
+
+struct split_fn {
+    template <std::ranges::range R>
+        requires std::invocable<const split_at_fn&,
+                                R,
+                                std::ranges::range_difference_t<R> >
+    constexpr auto operator()(R&& r, std::size_t n) const {
+        using diff_t  = std::ranges::range_difference_t<R>;
+        using piece_t = std::remove_cvref_t<
+            decltype(beman::transform_view::split_at((R&&)r, diff_t()).first)>;
+        static_assert(
+            std::same_as<
+                piece_t,
+                std::remove_cvref_t<decltype(beman::transform_view::split_at(
+                                                 std::declval<piece_t>(),
+                                                 diff_t())
+                                                 .first)> >,
+            "split() requires that splitting a piece yields the piece type");
+
+        std::vector<piece_t> result;
+        if (n == 0)
+            return result;
+        result.reserve(n);
+
+        const auto size  = std::size_t(std::ranges::distance(r));
+        const auto small = size / n;
+        const auto extra = size % n;
+
+        auto [first, rest] = beman::transform_view::split_at(
+            (R&&)r, diff_t(small + (0 < extra)));
+        result.push_back(std::move(first));
+        for (std::size_t i = 1; i < n; ++i) {
+            auto [piece, tail] = beman::transform_view::split_at(
+                std::move(rest), diff_t(small + (i < extra)));
+            result.push_back(std::move(piece));
+            rest = std::move(tail);
+        }
+        return result;
+    }
+};
+
+} // namespace detail
+
+/** Splits `r` into `n` consecutive subranges, whose sizes differ by at most
+    one, using `split_at()`, and returns them in a `std::vector`.  Returns an
+    empty `std::vector` if `n` is `0`.  The subranges of a `transform_view`
+    over a random-access, sized view are independent `transform_view`s that
+    can be handed to different threads; they are borrowed ranges when `F` is
+    tidy. */
+inline constexpr detail::split_fn split;
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_SPLIT_HPP
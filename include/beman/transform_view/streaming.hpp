@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_STREAMING_HPP
+#define BEMAN_TRANSFORM_VIEW_STREAMING_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#endif
+
+// Non-temporal stores are available through SSE2 on x86, and through a
+// builtin on Clang elsewhere.  Without either (or in the modules build),
+// materialize_streaming() uses ordinary stores.
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64))
+#define BEMAN_TRANSFORM_VIEW_STREAMING_STORES 1
+#include <emmintrin.h>
+#elif !BEMAN_TRANSFORM_VIEW_USE_MODULES() && defined(__clang__)
+#define BEMAN_TRANSFORM_VIEW_STREAMING_STORES 2
+#else
+#define BEMAN_TRANSFORM_VIEW_STREAMING_STORES 0
+#endif
+
+namespace beman::transform_view {
+
+/** The output size, in bytes, at and above which `materialize_streaming()`
+    uses non-temporal stores by default.  This is larger than the last-level
+    cache share of a core on most current hardware; below it, ordinary stores
+    are faster, since the output is likely to be read again soon. */
+inline constexpr std::size_t streaming_threshold = std::size_t(16) << 20;
+
+namespace detail {
+
+inline constexpr std::size_t cache_line = 64;
+
+// Copies n bytes, a multiple of cache_line, from src to the cache-line
+// aligned dst, bypassing the cache.
+inline void stream_lines(unsigned char*       dst,
+                         const unsigned char* src,
+                         std::size_t          n) noexcept {
+#if BEMAN_TRANSFORM_VIEW_STREAMING_STORES == 1
+    for (std::size_t i = 0; i < n; i += 16) {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_loadu_si128(
+                             reinterpret_cast<const __m128i*>(src + i)));
+    }
+#elif BEMAN_TRANSFORM_VIEW_STREAMING_STORES == 2
+    using line = std::uint64_t __attribute__((aligned(8)));
+    for (std::size_t i = 0; i < n; i += sizeof(line)) {
+        line x;
+        std::memcpy(&x, src + i, sizeof(line));
+        __builtin_nontemporal_store(x, reinterpret_cast<line*>(dst + i));
+    }
+#else
+    std::memcpy(dst, src, n);
+#endif
+}
+
+// Orders the non-temporal stores above before any later stores.
+inline void stream_fence() noexcept {
+#if BEMAN_TRANSFORM_VIEW_STREAMING_STORES == 1
+    _mm_sfence();
+#elif BEMAN_TRANSFORM_VIEW_STREAMING_STORES == 2
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+// Writes the elements of r to the bytes at dst.  Elements are produced into
+// a cache-resident staging buffer; the bytes up to dst's first cache-line
+// boundary are written with ordinary stores, then every whole line is
+// streamed out, and the partial line at the end is written with ordinary
+// stores again.
+template <typename T, typename R>
+void materialize_streaming_impl(R& r, unsigned char* dst) {
+    constexpr std::size_t stage_bytes = 16 * 1024;
+    constexpr std::size_t stage_elements =
+        (std::max)(std::size_t(1), stage_bytes / sizeof(T));
+
+    // Room for one batch of elements, plus less than a line carried over.
+    alignas(cache_line) unsigned char
+        stage[stage_elements * sizeof(T) + cache_line];
+
+    const std::size_t misalignment =
+        std::size_t(reinterpret_cast<std::uintptr_t>(dst) % cache_line);
+    std::size_t head = misalignment ? cache_line - misalignment : 0;
+    std::size_t left = std::size_t(std::ranges::distance(r));
+    std::size_t used = 0; // bytes waiting in stage
+
+    auto it = std::ranges::begin(r);
+    while (left != 0) {
+        const std::size_t k = (std::min)(left, stage_elements);
+        for (std::size_t i = 0; i < k; ++i, ++it) {
+            const T value(*it);
+            std::memcpy(stage + used + i * sizeof(T), &value, sizeof(T));
+        }
+        used += k * sizeof(T);
+        left -= k;
+
+        std::size_t done = (std::min)(head, used);
+        std::memcpy(dst, stage, done);
+        dst += done;
+        head -= done;
+        if (head == 0) {
+            const std::size_t lines =
+                (used - done) / cache_line * cache_line;
+            detail::stream_lines(dst, stage + done, lines);
+            dst += lines;
+            done += lines;
+        }
+        std::memmove(stage, stage + done, used - done);
+        used -= done;
+    }
+    std::memcpy(dst, stage, used);
+    detail::stream_fence();
+}
+
+} // namespace detail
+
+/** Copies the elements of `view` into the contiguous range `out`, and
+    returns the unused remainder of `out` as a `std::span`.
+
+    When the elements take up at least `threshold` bytes, they are written
+    with non-temporal stores, which do not read each destination cache line
+    before writing it, and do not evict the rest of the cache to make room
+    for the output.  That roughly halves the memory traffic of filling a
+    buffer much larger than the last-level cache.  The elements are
+    evaluated into a small buffer that stays in cache, and streamed out a
+    cache line at a time; the partial lines at either end of the output are
+    written normally, and the streaming stores are fenced before this
+    returns.  Below `threshold`, this is `std::ranges::copy()`.
+
+    \pre `std::ranges::size(view) <= std::ranges::size(out)` */
+template <std::ranges::input_range R, std::ranges::contiguous_range Out>
+    requires std::ranges::sized_range<R> && std::ranges::sized_range<Out> &&
+             std::is_trivially_copyable_v<std::ranges::range_value_t<Out> > &&
+             std::same_as<std::ranges::range_reference_t<Out>,
+                          std::ranges::range_value_t<Out>&> &&
+             std::indirectly_copyable<std::ranges::iterator_t<R>,
+                                      std::ranges::iterator_t<Out> > &&
+             std::constructible_from<std::ranges::range_value_t<Out>,
+                                     std::ranges::range_reference_t<R> >
+std::span<std::ranges::range_value_t<Out> > materialize_streaming(
+    R&& view, Out&& out, std::size_t threshold = streaming_threshold) {
+    using T = std::ranges::range_value_t<Out>;
+    std::span<T> out_span(std::ranges::data(out), std::ranges::size(out));
+    const auto   n = std::size_t(std::ranges::distance(view));
+    if (n * sizeof(T) < threshold || !BEMAN_TRANSFORM_VIEW_STREAMING_STORES)
+        std::ranges::copy(view, out_span.begin());
+    else
+        detail::materialize_streaming_impl<T>(
+            view, reinterpret_cast<unsigned char*>(out_span.data()));
+    return out_span.subspan(n);
+}
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_STREAMING_HPP
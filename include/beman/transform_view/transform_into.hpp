@@ -0,0 +1,239 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_TRANSFORM_INTO_HPP
+#define BEMAN_TRANSFORM_VIEW_TRANSFORM_INTO_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <concepts>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#endif
+
+namespace beman::transform_view {
+
+namespace detail {
+
+// The type of the output parameter of a callable that writes its result into
+// an Out&: the second parameter of a function pointer or of a class's
+// (non-template, non-overloaded) call operator.
+template <typename F>
+struct into_output {};
+template <typename R, typename In, typename Out, bool NoExcept>
+struct into_output<R (*)(In, Out&) noexcept(NoExcept)> {
+    using type = Out;
+};
+template <typename R, typename C, typename In, typename Out, bool NoExcept>
+struct into_output<R (C::*)(In, Out&) noexcept(NoExcept)> {
+    using type = Out;
+};
+template <typename R, typename C, typename In, typename Out, bool NoExcept>
+struct into_output<R (C::*)(In, Out&) const noexcept(NoExcept)> {
+    using type = Out;
+};
+template <typename F>
+    requires std::is_class_v<F> && requires { &F::operator(); }
+struct into_output<F> : into_output<decltype(&F::operator())> {};
+
+template <typename F>
+using into_output_t = typename into_output<F>::type;
+
+template <typename V, typename F, typename Out>
+concept can_transform_into =
+    std::ranges::input_range<V> && std::ranges::view<V> &&
+    std::move_constructible<F> && std::is_object_v<F> && std::movable<Out> &&
+    std::invocable<F&, std::ranges::range_reference_t<V>, Out&>;
+
+} // namespace detail
+
+/** An input view whose elements are written by `f(x, out)`, for each `x` in
+    `V`, into a single `Out` that the view owns.  Dereferencing an iterator
+    calls `f` once for the element it points to, and returns a reference to
+    that `Out`; the reference stays valid until the iterator is incremented,
+    or the view is moved or destroyed.  Since `f` is given the previous
+    element's `Out` to overwrite, a `std::string` or `std::vector` result
+    reuses its capacity from element to element instead of allocating each
+    time.
+
+    There is one `Out` per view, so the view is move-only and single-pass
+    whatever `V` is; to keep an element past the next increment, copy or move
+    it out of `*it`. */
+template <std::ranges::input_range V, typename F, typename Out>
+    requires detail::can_transform_into<V, F, Out>
+class transform_into_view
+    : public std::ranges::view_interface<transform_into_view<V, F, Out> > {
+    class sentinel;
+
+    class iterator {
+      public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type       = Out;
+        using difference_type  = std::ranges::range_difference_t<V>;
+
+        constexpr Out& operator*() const {
+            if (!parent_->filled_) {
+                std::invoke(*parent_->fun_, *current_, parent_->out_);
+                parent_->filled_ = true;
+            }
+            return parent_->out_;
+        }
+
+        constexpr iterator& operator++() {
+            ++current_;
+            parent_->filled_ = false;
+            return *this;
+        }
+        constexpr void operator++(int) { ++*this; }
+
+        constexpr const std::ranges::iterator_t<V>& base() const& noexcept {
+            return current_;
+        }
+        constexpr std::ranges::iterator_t<V> base() && {
+            return std::move(current_);
+        }
+
+      private:
+        friend transform_into_view;
+
+        constexpr iterator(transform_into_view*       parent,
+                           std::ranges::iterator_t<V> current)
+            : parent_(parent), current_(std::move(current)) {}
+
+        transform_into_view*       parent_;
+        std::ranges::iterator_t<V> current_;
+    };
+
+    class sentinel {
+      public:
+        sentinel() = default;
+
+        constexpr std::ranges::sentinel_t<V> base() const { return end_; }
+
+        friend constexpr bool operator==(const iterator& it,
+                                         const sentinel& s) {
+            return it.base() == s.end_;
+        }
+
+      private:
+        friend transform_into_view;
+
+        constexpr explicit sentinel(std::ranges::sentinel_t<V> end)
+            : end_(std::move(end)) {}
+
+        std::ranges::sentinel_t<V> end_ = std::ranges::sentinel_t<V>();
+    };
+
+  public:
+    constexpr transform_into_view(V base, F f)
+        requires std::default_initializable<Out>
+        : base_(std::move(base)), fun_(std::move(f)), out_() {}
+
+    /** Starts from `out`, e.g. a string with capacity reserved up front. */
+    constexpr transform_into_view(V base, F f, Out out)
+        : base_(std::move(base)), fun_(std::move(f)), out_(std::move(out)) {}
+
+    transform_into_view(transform_into_view&&)            = default;
+    transform_into_view& operator=(transform_into_view&&) = default;
+
+    constexpr V base() const&
+        requires std::copy_constructible<V>
+    {
+        return base_;
+    }
+    constexpr V base() && { return std::move(base_); }
+
+    /** Returns an iterator to the first element.  Must be called at most
+        once. */
+    constexpr iterator begin() {
+        filled_ = false;
+        return iterator(this, std::ranges::begin(base_));
+    }
+
+    constexpr sentinel end() { return sentinel(std::ranges::end(base_)); }
+
+    constexpr auto size()
+        requires std::ranges::sized_range<V>
+    {
+        return std::ranges::size(base_);
+    }
+
+  private:
+    V                                            base_ = V();
+    BEMAN_TRANSFORM_VIEW_NO_UNIQUE_ADDRESS detail::movable_box<F> fun_;
+    Out                                          out_;
+    bool                                         filled_ = false;
+};
+
+template <typename R, typename F>
+transform_into_view(R&&, F)
+    -> transform_into_view<std::views::all_t<R>, F, detail::into_output_t<F> >;
+
+template <typename R, typename F, typename Out>
+transform_into_view(R&&, F, Out)
+    -> transform_into_view<std::views::all_t<R>, F, Out>;
+
+namespace views {
+
+namespace detail {
+
+struct transform_into_impl {
+    template <std::ranges::viewable_range Range,
+              typename F,
+              typename G = std::decay_t<F> >
+        requires requires {
+            typename beman::transform_view::detail::into_output_t<G>;
+        } && beman::transform_view::detail::can_transform_into<
+                 std::views::all_t<Range>,
+                 G,
+                 beman::transform_view::detail::into_output_t<G> >
+    constexpr auto operator() [[nodiscard]] (Range&& r, F&& f) const {
+        return transform_into_view(std::views::all((Range&&)r), G((F&&)f));
+    }
+
+    template <std::ranges::viewable_range Range,
+              typename F,
+              typename Out,
+              typename G = std::decay_t<F> >
+        requires beman::transform_view::detail::can_transform_into<
+            std::views::all_t<Range>,
+            G,
+            std::decay_t<Out> >
+    constexpr auto operator() [[nodiscard]] (Range&& r,
+                                             F&&     f,
+                                             Out&&   out) const {
+        return transform_into_view(std::views::all((Range&&)r),
+                                   G((F&&)f),
+                                   std::decay_t<Out>((Out&&)out));
+    }
+};
+
+} // namespace detail
+
+/** Returns a `transform_into_view` that calls `f(x, out)` for each element
+    `x`, reusing one `out`.  `Out` is the type of `f`'s second parameter, or
+    that of `out` when given as `views::transform_into(f, out)`, which also
+    works for generic callables. */
+inline constexpr detail::adaptor<detail::transform_into_impl> transform_into =
+    detail::transform_into_impl{};
+
+} // namespace views
+
+} // namespace beman::transform_view
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_TRANSFORM_INTO_HPP
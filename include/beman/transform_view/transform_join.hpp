@@ -0,0 +1,269 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_TRANSFORM_JOIN_HPP
+#define BEMAN_TRANSFORM_VIEW_TRANSFORM_JOIN_HPP
+
+#include <beman/transform_view/config.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() && \
+    !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+import beman.transform_view;
+
+#else
+
+#include <beman/transform_view/transform_view.hpp>
+
+#if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#include <concepts>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#endif
+
+namespace beman::transform_view {
+
+namespace detail {
+
+template <typename V, typename F>
+using join_inner_t =
+    std::invoke_result_t<F&, std::ranges::range_reference_t<V> >;
+
+// True iff the ranges F makes from V's elements can be iterated after they
+// have been destroyed, so that an iterator can keep just their iterators.
+template <typename V, typename F>
+concept borrowed_inner =
+    std::ranges::input_range<V> &&
+    std::regular_invocable<F&, std::ranges::range_reference_t<V> > &&
+    std::ranges::input_range<join_inner_t<V, F> > &&
+    std::ranges::borrowed_range<join_inner_t<V, F> > &&
+    std::default_initializable<std::ranges::iterator_t<join_inner_t<V, F> > >;
+
+template <typename V, typename F>
+struct join_category_base {};
+template <typename V, typename F>
+    requires std::ranges::forward_range<V> &&
+             std::ranges::forward_range<join_inner_t<V, F> >
+struct join_category_base<V, F> {
+    using iterator_category = std::conditional_t<
+        std::is_reference_v<
+            std::ranges::range_reference_t<join_inner_t<V, F> > >,
+        std::forward_iterator_tag,
+        std::input_iterator_tag>;
+};
+
+} // namespace detail
+
+/** The elements of each of the ranges `f(x)`, for each `x` in `V`, in order:
+    `transform_join_view(v, f)` has the same elements as
+    `std::views::join(transform_view(v, f))`, for an `f` that returns a
+    borrowed range, such as a `std::span` or `std::string_view` into `x`.
+    Each iterator keeps its current inner range's iterator and sentinel,
+    rather than `join_view` caching the inner range in the view, so that the
+    view stays forward when `V` and the inner ranges are, is const-iterable,
+    and is borrowed when `V` is borrowed and `F` is tidy (see
+    `transform_view`).
+
+    The ranges `f` returns must not refer into an element of `V` that is a
+    prvalue, since that element is destroyed once `f` returns. */
+template <std::ranges::input_range V, std::move_constructible F>
+    requires std::ranges::view<V> && std::is_object_v<F> &&
+             detail::borrowed_inner<V, F>
+class transform_join_view
+    : public std::ranges::view_interface<transform_join_view<V, F> > {
+    template <bool Const>
+    class iterator
+        : public detail::join_category_base<detail::maybe_const<Const, V>,
+                                            detail::maybe_const<Const, F> > {
+        using Parent = detail::maybe_const<Const, transform_join_view>;
+        using Base   = detail::maybe_const<Const, V>;
+        using Fun    = detail::maybe_const<Const, F>;
+        using Inner  = detail::join_inner_t<Base, Fun>;
+
+        std::ranges::iterator_t<Base> outer_ =
+            std::ranges::iterator_t<Base>();
+        std::ranges::sentinel_t<Base> outer_end_ =
+            std::ranges::sentinel_t<Base>();
+        std::ranges::iterator_t<Inner> inner_ =
+            std::ranges::iterator_t<Inner>();
+        std::ranges::sentinel_t<Inner> inner_end_ =
+            std::ranges::sentinel_t<Inner>();
+        Parent* parent_ = nullptr;
+
+        constexpr Inner inner_range() const {
+            if constexpr (detail::tidy_func<F>)
+                return detail::invoke(F(), *outer_);
+            else
+                return detail::invoke(*parent_->fun_, *outer_);
+        }
+
+        // Moves to the first element of the first non-empty inner range at
+        // or after outer_, or to the end.
+        constexpr void satisfy() {
+            for (; outer_ != outer_end_; ++outer_) {
+                auto&& inner = inner_range();
+                inner_       = std::ranges::begin(inner);
+                inner_end_   = std::ranges::end(inner);
+                if (inner_ != inner_end_)
+                    return;
+            }
+            inner_     = std::ranges::iterator_t<Inner>();
+            inner_end_ = std::ranges::sentinel_t<Inner>();
+        }
+
+      public:
+        using iterator_concept =
+            std::conditional_t<std::ranges::forward_range<Base> &&
+                                   std::ranges::forward_range<Inner>,
+                               std::forward_iterator_tag,
+                               std::input_iterator_tag>;
+        using value_type      = std::ranges::range_value_t<Inner>;
+        using difference_type = std::common_type_t<
+            std::ranges::range_difference_t<Base>,
+            std::ranges::range_difference_t<Inner> >;
+
+        iterator()
+            requires std::default_initializable<std::ranges::iterator_t<Base> >
+        = default;
+        constexpr iterator(Parent&                       parent,
+                           std::ranges::iterator_t<Base> outer,
+                           std::ranges::sentinel_t<Base> outer_end)
+            : outer_(std::move(outer)),
+              outer_end_(std::move(outer_end)),
+              parent_(std::addressof(parent)) {
+            satisfy();
+        }
+
+        constexpr decltype(auto) operator*() const { return *inner_; }
+
+        constexpr iterator& operator++() {
+            if (++inner_ == inner_end_) {
+                ++outer_;
+                satisfy();
+            }
+            return *this;
+        }
+        constexpr void     operator++(int) { ++*this; }
+        constexpr iterator operator++(int)
+            requires std::ranges::forward_range<Base> &&
+                     std::ranges::forward_range<Inner>
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend constexpr bool operator==(const iterator& x, const iterator& y)
+            requires std::ranges::forward_range<Base> &&
+                     std::ranges::forward_range<Inner>
+        {
+            return x.outer_ == y.outer_ && x.inner_ == y.inner_;
+        }
+
+        friend constexpr bool operator==(const iterator& x,
+                                         std::default_sentinel_t) {
+            return x.outer_ == x.outer_end_;
+        }
+    };
+
+    V                                            base_ = V();
+    BEMAN_TRANSFORM_VIEW_NO_UNIQUE_ADDRESS detail::movable_box<F> fun_;
+
+    template <bool Const>
+    static constexpr bool common =
+        std::ranges::common_range<detail::maybe_const<Const, V> > &&
+        std::ranges::forward_range<detail::maybe_const<Const, V> > &&
+        std::ranges::forward_range<
+            detail::join_inner_t<detail::maybe_const<Const, V>,
+                                 detail::maybe_const<Const, F> > >;
+
+  public:
+    transform_join_view()
+        requires std::default_initializable<V> && std::default_initializable<F>
+    = default;
+    constexpr explicit transform_join_view(V base, F f)
+        : base_(std::move(base)), fun_(std::move(f)) {}
+
+    constexpr V base() const&
+        requires std::copy_constructible<V>
+    {
+        return base_;
+    }
+    constexpr V base() && { return std::move(base_); }
+
+    constexpr iterator<false> begin() {
+        return iterator<false>(
+            *this, std::ranges::begin(base_), std::ranges::end(base_));
+    }
+    constexpr iterator<true> begin() const
+        requires detail::borrowed_inner<const V, const F>
+    {
+        return iterator<true>(
+            *this, std::ranges::begin(base_), std::ranges::end(base_));
+    }
+
+    constexpr auto end() {
+        if constexpr (common<false>)
+            return iterator<false>(
+                *this, std::ranges::end(base_), std::ranges::end(base_));
+        else
+            return std::default_sentinel;
+    }
+    constexpr auto end() const
+        requires detail::borrowed_inner<const V, const F>
+    {
+        if constexpr (common<true>)
+            return iterator<true>(
+                *this, std::ranges::end(base_), std::ranges::end(base_));
+        else
+            return std::default_sentinel;
+    }
+};
+
+template <typename R, typename F>
+transform_join_view(R&&, F) -> transform_join_view<std::views::all_t<R>, F>;
+
+namespace views {
+
+namespace detail {
+
+struct transform_join_impl {
+    template <std::ranges::viewable_range Range, typename F>
+        requires can_transform_view<Range, F>
+    constexpr auto operator() [[nodiscard]] (Range&& r, F&& f) const {
+        using V = std::views::all_t<Range>;
+        using G = std::decay_t<F>;
+        if constexpr (beman::transform_view::detail::borrowed_inner<V, G>) {
+            return transform_join_view<V, G>(std::views::all((Range&&)r),
+                                             (F&&)f);
+        } else {
+            // The inner ranges must be kept alive while they are iterated,
+            // which only join_view's cache can do.
+            return std::views::join(transform_view((Range&&)r, (F&&)f));
+        }
+    }
+};
+
+} // namespace detail
+
+/** Returns a `transform_join_view` of `r` and `f` when `f` returns a borrowed
+    range, or else `std::views::join(transform_view(r, f))`. */
+inline constexpr detail::adaptor<detail::transform_join_impl> transform_join =
+    detail::transform_join_impl{};
+
+} // namespace views
+
+} // namespace beman::transform_view
+
+template <typename V, typename F>
+constexpr bool std::ranges::enable_borrowed_range<
+    beman::transform_view::transform_join_view<V, F> > =
+    std::ranges::borrowed_range<V> &&
+    beman::transform_view::detail::tidy_func<F>;
+
+#endif // BEMAN_TRANSFORM_VIEW_USE_MODULES() &&
+       // !defined(BEMAN_TRANSFORM_VIEW_INCLUDED_FROM_INTERFACE_UNIT)
+
+#endif // BEMAN_TRANSFORM_VIEW_TRANSFORM_JOIN_HPP
@@ -7,5 +7,25 @@ export {
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Winclude-angled-in-module-purview"
 #include <beman/transform_view/transform_view.hpp>
+#include <beman/transform_view/any_transform_view.hpp>
+#include <beman/transform_view/kernels.hpp>
+#include <beman/transform_view/reduce.hpp>
+#include <beman/transform_view/sort_by_cached_key.hpp>
+#include <beman/transform_view/split.hpp>
+#include <beman/transform_view/batch.hpp>
+#include <beman/transform_view/lut.hpp>
+#include <beman/transform_view/legacy_category.hpp>
+#include <beman/transform_view/streaming.hpp>
+#include <beman/transform_view/mdspan.hpp>
+#include <beman/transform_view/expr.hpp>
+#include <beman/transform_view/arena.hpp>
+#include <beman/transform_view/cstr.hpp>
+#include <beman/transform_view/pipelined.hpp>
+#include <beman/transform_view/file_chunks.hpp>
+#include <beman/transform_view/transform_into.hpp>
+#include <beman/transform_view/transform_join.hpp>
+#include <beman/transform_view/incremental.hpp>
+#include <beman/transform_view/bitpacked.hpp>
+#include <beman/transform_view/mpmc_queue.hpp>
 #pragma clang diagnostic pop
 }
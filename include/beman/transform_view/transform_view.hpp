@@ -13,14 +13,40 @@ import beman.transform_view;
 #else
 
 #if !BEMAN_TRANSFORM_VIEW_USE_MODULES()
+#if !BEMAN_TRANSFORM_VIEW_LIGHTWEIGHT()
 #include <functional>
-#include <iterator>
 #include <optional>
+#else
+#include <concepts>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#endif
+#include <iterator>
 #include <ranges>
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+#define BEMAN_TRANSFORM_VIEW_ALWAYS_INLINE [[gnu::always_inline]] inline
+#elif defined(_MSC_VER)
+#define BEMAN_TRANSFORM_VIEW_ALWAYS_INLINE [[msvc::forceinline]] inline
+#else
+#define BEMAN_TRANSFORM_VIEW_ALWAYS_INLINE inline
+#endif
+
 namespace beman::transform_view {
 
+/** Specialize this to `true` for a callable type `F` to have the iterators
+    of `transform_view<V, F>` report `V`'s iterator category (at most
+    `std::random_access_iterator_tag`) as their `iterator_category`, even when
+    `F` returns by value.  Such iterators do not meet the legacy forward
+    iterator requirement that `reference` be a reference type, but code
+    written against the legacy requirements can then size, reserve for and
+    parallelize over them, as with Boost's `transform_iterator`. */
+template <typename F>
+constexpr bool enable_legacy_iterator_category = false;
+
 namespace detail {
 template <bool Const, typename T>
 using maybe_const = std::conditional_t<Const, const T, T>;
@@ -50,7 +76,8 @@ constexpr auto category_tag() {
     } else {
         constexpr bool call_result_is_ref = std::is_reference_v<
             std::invoke_result_t<F&, std::ranges::range_reference_t<Base> > >;
-        if constexpr (call_result_is_ref) {
+        if constexpr (call_result_is_ref ||
+                      enable_legacy_iterator_category<std::remove_cv_t<F> >) {
             using C = typename std::iterator_traits<
                 std::ranges::iterator_t<Base> >::iterator_category;
             if constexpr (std::derived_from<C, std::contiguous_iterator_tag>) {
@@ -72,9 +99,109 @@ struct iterator_category_base {
 template <typename Base, typename F>
 struct iterator_category_base<Base, F, int> {};
 
+#if BEMAN_TRANSFORM_VIEW_LIGHTWEIGHT()
+// Returns the object that the member pointer invocation INVOKE(pm, obj, ...)
+// applies pm to: obj itself, the object a std::reference_wrapper refers to,
+// or *obj.  std::unwrap_reference_t, from <type_traits>, picks out
+// std::reference_wrapper without needing <functional>.
+template <typename T, typename Obj>
+constexpr decltype(auto) member_object(Obj&& obj) {
+    using U = std::remove_cvref_t<Obj>;
+    if constexpr (std::is_base_of_v<T, U>)
+        return (Obj&&)obj;
+    else if constexpr (!std::same_as<std::unwrap_reference_t<U>, U>)
+        return obj.get();
+    else
+        return *(Obj&&)obj;
+}
+
+template <typename M, typename T, typename Obj, typename... Args>
+constexpr decltype(auto)
+invoke_member(M T::* pm, Obj&& obj, Args&&... args) {
+    if constexpr (std::is_function_v<M>)
+        return (detail::member_object<T>((Obj&&)obj).*pm)((Args&&)args...);
+    else
+        return detail::member_object<T>((Obj&&)obj).*pm;
+}
+#endif
+
+// std::invoke, except that callables other than member pointers are called
+// directly, so that even unoptimized builds do not make an extra function
+// call per element.
+template <typename F, typename... Args>
+BEMAN_TRANSFORM_VIEW_ALWAYS_INLINE constexpr decltype(auto)
+invoke(F&& f, Args&&... args) noexcept(
+    std::is_nothrow_invocable_v<F, Args...>) {
+    if constexpr (!std::is_member_pointer_v<std::remove_cvref_t<F> >) {
+        return ((F&&)f)((Args&&)args...);
+    } else {
+#if BEMAN_TRANSFORM_VIEW_LIGHTWEIGHT()
+        return detail::invoke_member(f, (Args&&)args...);
+#else
+        return std::invoke(f, (Args&&)args...);
+#endif
+    }
+}
+
 template <typename T>
 concept boxable = std::move_constructible<T> && std::is_object_v<T>;
 
+#if BEMAN_TRANSFORM_VIEW_LIGHTWEIGHT()
+// Holds a T directly, rather than in a std::optional.  A T that cannot be
+// assigned is instead destroyed and reconstructed in place; since the box
+// has no empty state to fall back on, the program terminates if that
+// reconstruction throws.
+template <boxable T>
+class movable_box {
+    BEMAN_TRANSFORM_VIEW_NO_UNIQUE_ADDRESS T value_;
+
+  public:
+    constexpr movable_box() noexcept(std::is_nothrow_default_constructible_v<T>)
+        requires std::default_initializable<T>
+        : value_() {}
+
+    template <typename U>
+        requires(!std::same_as<std::remove_cvref_t<U>, movable_box>) &&
+                std::constructible_from<T, U>
+    constexpr explicit movable_box(U&& u) noexcept(
+        std::is_nothrow_constructible_v<T, U>)
+        : value_((U&&)u) {}
+
+    movable_box(const movable_box&) = default;
+    movable_box(movable_box&&)      = default;
+
+    movable_box& operator=(const movable_box&)
+        requires std::copyable<T>
+    = default;
+    movable_box& operator=(movable_box&&)
+        requires std::movable<T>
+    = default;
+
+    movable_box& operator=(const movable_box& rhs) noexcept
+        requires(!std::copyable<T>) && std::copy_constructible<T>
+    {
+        if (std::addressof(rhs) != this) {
+            value_.~T();
+            ::new (static_cast<void*>(std::addressof(value_))) T(rhs.value_);
+        }
+        return *this;
+    }
+
+    movable_box& operator=(movable_box&& rhs) noexcept
+        requires(!std::movable<T>)
+    {
+        if (std::addressof(rhs) != this) {
+            value_.~T();
+            ::new (static_cast<void*>(std::addressof(value_)))
+                T(std::move(rhs.value_));
+        }
+        return *this;
+    }
+
+    constexpr T&       operator*() noexcept { return value_; }
+    constexpr const T& operator*() const noexcept { return value_; }
+};
+#else
 template <boxable T>
 struct movable_box : std::optional<T> {
     constexpr movable_box() noexcept(std::is_nothrow_default_constructible_v<T>)
@@ -113,6 +240,7 @@ struct movable_box : std::optional<T> {
     using std::optional<T>::optional;
     using std::optional<T>::operator=;
 };
+#endif
 
 // [ tidy_func
 template <class F>
@@ -125,21 +253,33 @@ constexpr bool tidy_func = std::is_empty_v<F> &&
                            std::is_trivially_destructible_v<F>;
 // ]
 
-// Workaround for shitty MSVC friendship implementation.
-#if defined(_MSC_VER)
+template <typename R>
+concept sized_random_access_non_common =
+    std::ranges::random_access_range<R> && std::ranges::sized_range<R> &&
+    !std::ranges::common_range<R>;
+
+// Gives the extension headers access to the callable stored in a
+// transform_view.
+struct view_access;
+
+// Gives the sentinel's comparison operators access to an iterator's
+// position.  MSVC, and GCC (see CWG 1699), do not let a friend function
+// defined in a befriended class use the befriending class's private
+// members.
 struct iter_access {
     template <typename T>
-    static decltype(auto) current(const T& it) {
+    static constexpr const auto& current(const T& it) noexcept {
         return it.current_;
     }
 };
-#endif
 } // namespace detail
 
 /** An updated transform_view whose iterator constructs an `F` on the fly --
     rather than using the one stored in the view -- when `F` can be trivially
     constructed and destructed.  This makes this transform_view conditionally
-    borrowable.  Note that this template derives from \<Stdref
+    borrowable.  When `V` is sized and random-access but not common, `end()`
+    returns `begin() + size()` rather than a sentinel, so that the
+    transform_view is common.  Note that this template derives from \<Stdref
     ref="view.interface"/>, and so has many operations not explicitly
     documented below. */
 template <std::ranges::input_range V, std::move_constructible F>
@@ -162,12 +302,7 @@ class transform_view
             std::ranges::iterator_t<Base>();
         Parent* parent_ = nullptr;
 
-#if defined(_MSC_VER)
         friend detail::iter_access;
-#else
-        template <bool>
-        friend class sentinel;
-#endif
 
       public:
         using iterator_concept = decltype(detail::concept_tag<Base>());
@@ -196,15 +331,15 @@ class transform_view
         }
 
         constexpr decltype(auto) operator*() const
-            noexcept(noexcept(std::invoke(*parent_->fun_, *current_))) {
-            return std::invoke(*parent_->fun_, *current_);
+            noexcept(noexcept(detail::invoke(*parent_->fun_, *current_))) {
+            return detail::invoke(*parent_->fun_, *current_);
         }
 
         constexpr decltype(auto) operator*() const
-            noexcept(noexcept(std::invoke(F(), *current_)))
+            noexcept(noexcept(detail::invoke(F(), *current_)))
             requires detail::tidy_func<F>
         {
-            return std::invoke(F(), *current_);
+            return detail::invoke(F(), *current_);
         }
 
         constexpr iterator& operator++() {
@@ -251,9 +386,9 @@ class transform_view
             requires std::ranges::random_access_range<Base>
         {
             if constexpr (detail::tidy_func<F>)
-                return std::invoke(F(), current_[n]);
+                return detail::invoke(F(), current_[n]);
             else
-                return std::invoke(*parent_->fun_, current_[n]);
+                return detail::invoke(*parent_->fun_, current_[n]);
         }
 
         friend constexpr bool operator==(const iterator& x, const iterator& y)
@@ -341,11 +476,7 @@ class transform_view
                 std::ranges::iterator_t<detail::maybe_const<OtherConst, V> > >
         friend constexpr bool operator==(const iterator<OtherConst>& x,
                                          const sentinel&             y) {
-#if defined(_MSC_VER)
             return detail::iter_access::current(x) == y.end_;
-#else
-            return x.current_ == y.end_;
-#endif
         }
 
         template <bool OtherConst>
@@ -355,11 +486,7 @@ class transform_view
         friend constexpr std::ranges::range_difference_t<
             detail::maybe_const<OtherConst, V> >
         operator-(const iterator<OtherConst>& x, const sentinel& y) {
-#if defined(_MSC_VER)
             return detail::iter_access::current(x) - y.end_;
-#else
-            return x.current_ - y.end_;
-#endif
         }
 
         template <bool OtherConst>
@@ -369,16 +496,14 @@ class transform_view
         friend constexpr std::ranges::range_difference_t<
             detail::maybe_const<OtherConst, V> >
         operator-(const sentinel& y, const iterator<OtherConst>& x) {
-#if defined(_MSC_VER)
             return y.end_ - detail::iter_access::current(x);
-#else
-            return y.end_ - x.current_;
-#endif
         }
     };
 
     V                                            base_ = V();
-    [[no_unique_address]] detail::movable_box<F> fun_;
+    BEMAN_TRANSFORM_VIEW_NO_UNIQUE_ADDRESS detail::movable_box<F> fun_;
+
+    friend detail::view_access;
 
   public:
     /** Default constructor. */
@@ -427,6 +552,17 @@ class transform_view
         return iterator<false>{*this, std::ranges::end(base_)};
     }
 
+    /** Returns a non-`const` iterator for the end of `*this`, when `V` is not
+        common but is sized and random-access, so that `*this` is always a
+        `common_range` in that case.  This is constant-time. */
+    constexpr iterator<false> end()
+        requires detail::sized_random_access_non_common<V>
+    {
+        return iterator<false>{*this,
+                               std::ranges::begin(base_) +
+                                   std::ranges::distance(base_)};
+    }
+
     /** Returns a `const` sentinel for the end of `*this`. */
     constexpr sentinel<true> end() const
         requires std::ranges::range<const V> &&
@@ -447,6 +583,19 @@ class transform_view
         return iterator<true>{*this, std::ranges::end(base_)};
     }
 
+    /** Returns a `const` iterator for the end of `*this`, when `const V` is
+        not common but is sized and random-access. */
+    constexpr iterator<true> end() const
+        requires detail::sized_random_access_non_common<const V> &&
+                 std::regular_invocable<
+                     const F&,
+                     std::ranges::range_reference_t<const V> >
+    {
+        return iterator<true>{*this,
+                              std::ranges::begin(base_) +
+                                  std::ranges::distance(base_)};
+    }
+
     /** Returns the number of elements in `*this`. */
     constexpr auto size()
         requires std::ranges::sized_range<V>
@@ -467,6 +616,30 @@ class transform_view
 template <typename R, typename F>
 transform_view(R&&, F) -> transform_view<std::ranges::views::all_t<R>, F>;
 
+namespace detail {
+template <typename R>
+struct transform_view_traits {
+    static constexpr bool is_transform_view = false;
+};
+template <typename V, typename F>
+struct transform_view_traits<transform_view<V, F> > {
+    static constexpr bool is_transform_view = true;
+    using base_type                         = V;
+    using func_type                         = F;
+};
+
+struct view_access {
+    template <typename V, typename F>
+    static constexpr const F& fun(const transform_view<V, F>& view) noexcept {
+        return *view.fun_;
+    }
+    template <typename V, typename F>
+    static constexpr F& fun(transform_view<V, F>& view) noexcept {
+        return *view.fun_;
+    }
+};
+} // namespace detail
+
 namespace views {
 
 namespace detail {
@@ -480,7 +653,13 @@ concept can_transform_view =
      !defined(__clang__))
 template <typename T>
 using range_adaptor_closure = std::ranges::range_adaptor_closure<T>;
+#define BEMAN_TRANSFORM_VIEW_STD_ADAPTOR_CLOSURE 1
+#else
+#define BEMAN_TRANSFORM_VIEW_STD_ADAPTOR_CLOSURE 0
+#endif
 
+#if BEMAN_TRANSFORM_VIEW_STD_ADAPTOR_CLOSURE && \
+    !BEMAN_TRANSFORM_VIEW_LIGHTWEIGHT()
 template <typename Func, typename... Args>
 constexpr auto bind_back(Func&& f, Args&&... args) {
     return std::bind_back((Func&&)f, (Args&&)args...);
@@ -498,21 +677,25 @@ struct bind_back_t {
     }
 
     template <typename... Args>
+        requires std::invocable<Func&, Args..., CapturedArgs&...>
     constexpr decltype(auto) operator()(Args&&... args) & {
         return call_impl(*this, indices(), (Args&&)args...);
     }
 
     template <typename... Args>
+        requires std::invocable<const Func&, Args..., const CapturedArgs&...>
     constexpr decltype(auto) operator()(Args&&... args) const& {
         return call_impl(*this, indices(), (Args&&)args...);
     }
 
     template <typename... Args>
+        requires std::invocable<Func, Args..., CapturedArgs...>
     constexpr decltype(auto) operator()(Args&&... args) && {
         return call_impl(std::move(*this), indices(), (Args&&)args...);
     }
 
     template <typename... Args>
+        requires std::invocable<const Func, Args..., const CapturedArgs...>
     constexpr decltype(auto) operator()(Args&&... args) const&& {
         return call_impl(std::move(*this), indices(), (Args&&)args...);
     }
@@ -527,8 +710,8 @@ struct bind_back_t {
             .f_((Args&&)args..., std::get<I>(((T&&)this_).bound_args_)...);
     }
 
-    [[no_unique_address]] Func  f_;
-    std::tuple<CapturedArgs...> bound_args_;
+    BEMAN_TRANSFORM_VIEW_NO_UNIQUE_ADDRESS Func f_;
+    std::tuple<CapturedArgs...>                 bound_args_;
 };
 
 template <typename Func, typename... Args>
@@ -539,6 +722,9 @@ constexpr auto bind_back(Func&& f, Args&&... args) {
     return detail::bind_back_result<Func, Args...>(
         0, (Func&&)f, (Args&&)args...);
 }
+#endif
+
+#if !BEMAN_TRANSFORM_VIEW_STD_ADAPTOR_CLOSURE
 
 template <typename D>
     requires std::is_class_v<D> && std::same_as<D, std::remove_cv_t<D> >
@@ -561,7 +747,12 @@ struct range_adaptor_closure {
 
 template <typename F>
 struct closure : range_adaptor_closure<closure<F> > {
-    constexpr closure(F f) : f_(f) {}
+    constexpr closure(F f) : f_(std::move(f)) {}
+
+    // Initializes f_ directly from the prvalue make() returns, so that
+    // building a closure does not move the bound arguments once more.
+    template <typename Make>
+    constexpr closure(std::in_place_t, Make make) : f_(make()) {}
 
     template <typename T>
         requires std::invocable<const F&, T>
@@ -576,24 +767,27 @@ struct closure : range_adaptor_closure<closure<F> > {
     }
 
   private:
-    [[no_unique_address]] F f_;
+    BEMAN_TRANSFORM_VIEW_NO_UNIQUE_ADDRESS F f_;
 };
 
 template <typename F>
 struct adaptor {
-    constexpr adaptor(F f) : f_(f) {}
+    constexpr adaptor(F f) : f_(std::move(f)) {}
 
     template <typename... Args>
     constexpr auto operator()(Args&&... args) const {
         if constexpr (std::is_invocable_v<const F&, Args...>) {
             return f_((Args&&)args...);
         } else {
-            return closure(detail::bind_back(f_, (Args&&)args...));
+            using bound_type = decltype(detail::bind_back(f_, (Args&&)args...));
+            return closure<bound_type>(std::in_place, [&] {
+                return detail::bind_back(f_, (Args&&)args...);
+            });
         }
     }
 
   private:
-    [[no_unique_address]] F f_;
+    BEMAN_TRANSFORM_VIEW_NO_UNIQUE_ADDRESS F f_;
 };
 
 } // namespace detail
@@ -610,6 +804,87 @@ struct transform_impl {
 inline constexpr detail::adaptor<transform_impl> transform = transform_impl{};
 } // namespace views
 
+namespace detail {
+
+template <typename A, typename Adaptor, typename... Counts>
+inline constexpr bool is_counted_closure =
+    (std::same_as<A,
+                  std::remove_cvref_t<decltype(std::declval<const Adaptor&>()(
+                      std::declval<Counts>()))> > ||
+     ...);
+
+// True iff A is what Adaptor returns when called with an integer count, as
+// in std::views::take(3).
+template <typename A, typename Adaptor>
+inline constexpr bool is_bound_to_count =
+    is_counted_closure<A,
+                       Adaptor,
+                       int,
+                       long,
+                       long long,
+                       unsigned,
+                       unsigned long,
+                       unsigned long long>;
+
+template <typename A>
+inline constexpr bool is_stride_closure =
+#if defined(__cpp_lib_ranges_stride)
+    is_bound_to_count<A, std::remove_cvref_t<decltype(std::views::stride)> >;
+#else
+    false;
+#endif
+
+// The standard adaptors that only pick or reorder elements, so that applying
+// them to a transform_view's base gives the same elements as applying them to
+// the view, with a single transform on top.
+template <typename A>
+concept commuting_adaptor =
+    std::same_as<A, std::remove_cvref_t<decltype(std::views::reverse)> > ||
+    is_bound_to_count<A, std::remove_cvref_t<decltype(std::views::take)> > ||
+    is_bound_to_count<A, std::remove_cvref_t<decltype(std::views::drop)> > ||
+    is_stride_closure<A>;
+
+template <typename V, typename F, typename A>
+concept can_commute =
+    commuting_adaptor<std::remove_cvref_t<A> > && std::invocable<A, V> &&
+    views::detail::can_transform_view<std::invoke_result_t<A, V>, F>;
+
+template <typename V, typename F, typename A>
+constexpr auto commute(V base, F f, A&& a) {
+    return transform_view(((A&&)a)(std::move(base)), std::move(f));
+}
+} // namespace detail
+
+/**
+ * Applies std::views::reverse, or std::views::take, drop or stride with a
+ * count, to the base of `r` rather than to `r`, giving
+ * `transform_view(r.base() | a, f)`.  This has the same elements as the
+ * result of the standard adaptor, but no second layer of iterators: a
+ * reversed transform_view does not step a copy of its iterator back on each
+ * dereference, and a transform_view over a span, taken or dropped, is a
+ * transform_view over a span, which is borrowed when `f` is tidy.
+ */
+template <typename V, typename F, typename A>
+    requires detail::can_commute<V, F, A>
+[[nodiscard]] constexpr auto operator|(transform_view<V, F>&& r, A&& a) {
+    F f = std::move(detail::view_access::fun(r));
+    return detail::commute(std::move(r).base(), std::move(f), (A&&)a);
+}
+
+template <typename V, typename F, typename A>
+    requires std::copy_constructible<V> && std::copy_constructible<F> &&
+             detail::can_commute<V, F, A>
+[[nodiscard]] constexpr auto operator|(const transform_view<V, F>& r, A&& a) {
+    return detail::commute(r.base(), detail::view_access::fun(r), (A&&)a);
+}
+
+template <typename V, typename F, typename A>
+    requires std::copy_constructible<V> && std::copy_constructible<F> &&
+             detail::can_commute<V, F, A>
+[[nodiscard]] constexpr auto operator|(transform_view<V, F>& r, A&& a) {
+    return detail::commute(r.base(), detail::view_access::fun(r), (A&&)a);
+}
+
 } // namespace beman::transform_view
 
 template <typename T, typename F>
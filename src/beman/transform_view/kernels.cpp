@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/kernels.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+// Each kernel is compiled once per instruction set, using function-level
+// target attributes where the compiler supports them, and the widest version
+// the host supports is chosen once, the first time any kernel is called.
+//
+// The pointers are not __restrict: transform() may be called in place, with
+// out == in.  The compiler still vectorizes the loops, after a run-time
+// check that the arrays are equal or do not overlap.
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define BEMAN_TRANSFORM_VIEW_KERNELS_MULTIVERSION 1
+#define BEMAN_TRANSFORM_VIEW_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BEMAN_TRANSFORM_VIEW_KERNELS_MULTIVERSION 0
+#endif
+
+namespace beman::transform_view::kernels {
+
+namespace detail {
+
+namespace {
+
+template <typename T>
+using kernel_fn = void (*)(const T*, std::size_t, T*) noexcept;
+
+template <typename Op, typename T>
+void portable(const T* in, std::size_t n, T* out) noexcept {
+    detail::portable_kernel<Op, T>(in, n, out);
+}
+
+#if BEMAN_TRANSFORM_VIEW_KERNELS_MULTIVERSION
+template <typename Op, typename T>
+BEMAN_TRANSFORM_VIEW_TARGET("sse2")
+void sse2(const T* in, std::size_t n, T* out) noexcept {
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = Op()(in[i]);
+}
+
+template <typename Op, typename T>
+BEMAN_TRANSFORM_VIEW_TARGET("avx2")
+void avx2(const T* in, std::size_t n, T* out) noexcept {
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = Op()(in[i]);
+}
+
+template <typename Op, typename T>
+BEMAN_TRANSFORM_VIEW_TARGET("avx512f,avx512bw")
+void avx512(const T* in, std::size_t n, T* out) noexcept {
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = Op()(in[i]);
+}
+#endif
+
+isa detect_isa() noexcept {
+#if BEMAN_TRANSFORM_VIEW_KERNELS_MULTIVERSION
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512bw"))
+        return isa::avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return isa::avx2;
+    if (__builtin_cpu_supports("sse2"))
+        return isa::sse2;
+#endif
+    return isa::portable;
+}
+
+template <typename Op, typename T>
+kernel_fn<T> select_kernel() noexcept {
+#if BEMAN_TRANSFORM_VIEW_KERNELS_MULTIVERSION
+    switch (detail::select_isa()) {
+    case isa::avx512:
+        return &avx512<Op, T>;
+    case isa::avx2:
+        return &avx2<Op, T>;
+    case isa::sse2:
+        return &sse2<Op, T>;
+    case isa::portable:
+        break;
+    }
+#endif
+    return &portable<Op, T>;
+}
+
+} // namespace
+
+isa select_isa() noexcept {
+    static const isa result = detect_isa();
+    return result;
+}
+
+template <typename Op, typename T>
+void dispatched_kernel(const T* in, std::size_t n, T* out) noexcept {
+    static const kernel_fn<T> kernel = select_kernel<Op, T>();
+    kernel(in, n, out);
+}
+
+#define BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(op, type)    \
+    template void dispatched_kernel<op, type>(               \
+        const type*, std::size_t, type*) noexcept
+
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(negate_fn, float);
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(negate_fn, double);
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(negate_fn, std::int32_t);
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(negate_fn, std::int64_t);
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(abs_fn, float);
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(abs_fn, double);
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(abs_fn, std::int32_t);
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(abs_fn, std::int64_t);
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(square_fn, float);
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(square_fn, double);
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(square_fn, std::int32_t);
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(square_fn, std::int64_t);
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(ascii_to_lower_fn, char);
+BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL(ascii_to_upper_fn, char);
+
+#undef BEMAN_TRANSFORM_VIEW_INSTANTIATE_KERNEL
+
+} // namespace detail
+
+} // namespace beman::transform_view::kernels
@@ -0,0 +1,171 @@
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# Compiles SOURCE with the vectorizer's remarks enabled, and fails unless each
+# kernel tv_<name> in SOURCE has as many vectorized loops as raw_<name>, and
+# raw_<name> has at least one (none if it is marked "scalar").
+#
+# If NM is set, SOURCE is also compiled with SCALAR_FLAGS, which turn the
+# vectorizer off, and each tv_<name> must then compile to no more bytes than
+# raw_<name>.  This catches per-element work the optimizer cannot remove from
+# a transform_view loop, such as a reload through parent_, which vectorizing
+# with run-time alias checks would hide from the remarks.
+#
+# Usage:
+#   cmake -DCOMPILER=<c++> -DFLAGS=<flags separated by |> -DSOURCE=<file>
+#         -DOBJECT=<file> -DSTAMP=<file>
+#         [-DNM=<nm> -DSCALAR_FLAGS=<flags separated by |>]
+#         -P check_vectorization.cmake
+#
+# Kernels are delimited in SOURCE by "// kernel: <name>" (or
+# "// kernel: <name> scalar") and "// end kernel" lines, and have C linkage.
+
+foreach(var COMPILER FLAGS SOURCE OBJECT STAMP)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "check_vectorization.cmake: ${var} is not set")
+    endif()
+endforeach()
+
+string(REPLACE "|" ";" flags "${FLAGS}")
+execute_process(
+    COMMAND "${COMPILER}" ${flags} -c "${SOURCE}" -o "${OBJECT}"
+    RESULT_VARIABLE result
+    OUTPUT_VARIABLE remarks
+    ERROR_VARIABLE remarks
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Compiling ${SOURCE} failed:\n${remarks}")
+endif()
+
+# Find the line range of each kernel.  Semicolons and brackets are replaced
+# first, so that each source line becomes exactly one list element.
+file(READ "${SOURCE}" content)
+string(REGEX REPLACE "[][;]" "_" content "${content}")
+string(REPLACE "\n" ";" lines "${content}")
+set(kernels)
+set(line_number 0)
+foreach(line IN LISTS lines)
+    math(EXPR line_number "${line_number} + 1")
+    if(line MATCHES "^// kernel: ([A-Za-z0-9_]+)( scalar)?$")
+        set(current "${CMAKE_MATCH_1}")
+        list(APPEND kernels "${current}")
+        set(first_${current} ${line_number})
+        set(count_${current} 0)
+        if(CMAKE_MATCH_2)
+            set(scalar_${current} TRUE)
+        else()
+            set(scalar_${current} FALSE)
+        endif()
+    elseif(line MATCHES "^// end kernel$")
+        set(last_${current} ${line_number})
+    endif()
+endforeach()
+
+# Attribute each "loop vectorized" (GCC) or "vectorized loop" (Clang) remark
+# to the kernel containing its line.
+get_filename_component(source_name "${SOURCE}" NAME)
+string(REGEX REPLACE "[][;]" "_" remarks "${remarks}")
+string(REPLACE "\n" ";" remark_lines "${remarks}")
+foreach(line IN LISTS remark_lines)
+    if(
+        line MATCHES "${source_name}:([0-9]+):[0-9]+:.*(loop vectorized|vectorized loop)"
+    )
+        set(remark_line ${CMAKE_MATCH_1})
+        foreach(kernel IN LISTS kernels)
+            if(
+                remark_line GREATER_EQUAL first_${kernel}
+                AND remark_line LESS_EQUAL last_${kernel}
+            )
+                math(EXPR count_${kernel} "${count_${kernel}} + 1")
+            endif()
+        endforeach()
+    endif()
+endforeach()
+
+set(failures)
+foreach(kernel IN LISTS kernels)
+    if(kernel MATCHES "^tv_(.*)$")
+        set(raw "raw_${CMAKE_MATCH_1}")
+        if(NOT DEFINED count_${raw})
+            message(FATAL_ERROR "${SOURCE}: ${kernel} has no ${raw}")
+        endif()
+        message(
+            STATUS
+            "${kernel}: ${count_${kernel}} vectorized loop(s); ${raw}: ${count_${raw}}"
+        )
+        if(NOT count_${kernel} EQUAL count_${raw})
+            list(APPEND failures "${kernel}")
+        endif()
+        if(scalar_${raw})
+            if(NOT count_${raw} EQUAL 0)
+                list(APPEND failures "${raw} (marked scalar)")
+            endif()
+        elseif(count_${raw} EQUAL 0)
+            list(APPEND failures "${raw} (not vectorized)")
+        endif()
+    endif()
+endforeach()
+
+if(failures)
+    message(
+        FATAL_ERROR
+        "These kernels did not vectorize as expected: ${failures}\n${remarks}"
+    )
+endif()
+
+if(NM)
+    string(REPLACE "|" ";" scalar_flags "${SCALAR_FLAGS}")
+    execute_process(
+        COMMAND
+            "${COMPILER}" ${flags} ${scalar_flags} -c "${SOURCE}" -o
+            "${OBJECT}.scalar.o"
+        RESULT_VARIABLE result
+        ERROR_VARIABLE errors
+    )
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Compiling ${SOURCE} failed:\n${errors}")
+    endif()
+    execute_process(
+        COMMAND "${NM}" -S "${OBJECT}.scalar.o"
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE symbols
+        ERROR_QUIET
+    )
+    if(NOT result EQUAL 0)
+        message(STATUS "${NM} cannot print symbol sizes; not comparing them")
+        file(TOUCH "${STAMP}")
+        return()
+    endif()
+
+    # Lines look like "<address> <size> T <name>", with a leading underscore
+    # on some platforms.
+    string(REPLACE "\n" ";" symbol_lines "${symbols}")
+    foreach(line IN LISTS symbol_lines)
+        if(line MATCHES "^[0-9a-fA-F]+ ([0-9a-fA-F]+) [Tt] _?([A-Za-z0-9_]+)$")
+            math(EXPR size_${CMAKE_MATCH_2} "0x${CMAKE_MATCH_1}")
+        endif()
+    endforeach()
+
+    foreach(kernel IN LISTS kernels)
+        if(kernel MATCHES "^tv_(.*)$")
+            set(raw "raw_${CMAKE_MATCH_1}")
+            if(NOT DEFINED size_${kernel} OR NOT DEFINED size_${raw})
+                message(FATAL_ERROR "${NM} did not list ${kernel} and ${raw}")
+            endif()
+            message(
+                STATUS
+                "${kernel}: ${size_${kernel}} bytes without vectorization; ${raw}: ${size_${raw}}"
+            )
+            if(size_${kernel} GREATER size_${raw})
+                list(APPEND failures "${kernel}")
+            endif()
+        endif()
+    endforeach()
+    if(failures)
+        message(
+            FATAL_ERROR
+            "These transform_view kernels compiled to more code than their raw equivalents: ${failures}"
+        )
+    endif()
+endif()
+
+file(TOUCH "${STAMP}")
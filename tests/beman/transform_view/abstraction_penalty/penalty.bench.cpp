@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Times each tv_<name>() kernel in penalty_kernels.cpp against its
+// raw_<name>() equivalent, and fails if any transform_view kernel is slower
+// than its raw loop by more than the tolerance (default 1.25; pass another
+// ratio as the first argument).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "penalty_kernels.hpp"
+
+namespace {
+
+constexpr std::size_t size        = 1 << 14;
+constexpr int         repetitions = 200;
+constexpr int         rounds      = 15;
+constexpr int         attempts    = 3;
+
+volatile long long sink;
+
+template <typename Func>
+double seconds(Func f) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; ++i)
+        f();
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// Rounds alternate between the two kernels, and the fastest round of each
+// counts, so that machine noise affects both alike.  A pair that misses the
+// tolerance is re-measured a few times before it counts as a failure.
+bool compare(const char* name, double tolerance, auto tv, auto raw) {
+    tv();
+    raw();
+    double tv_seconds  = 0;
+    double raw_seconds = 0;
+    double ratio       = 0;
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        tv_seconds  = 1e300;
+        raw_seconds = 1e300;
+        for (int round = 0; round < rounds; ++round) {
+            tv_seconds  = (std::min)(tv_seconds, seconds(tv));
+            raw_seconds = (std::min)(raw_seconds, seconds(raw));
+        }
+        ratio = tv_seconds / raw_seconds;
+        if (ratio <= tolerance)
+            break;
+    }
+    const bool ok = ratio <= tolerance;
+    std::printf("%-10s transform_view %9.3f us  raw %9.3f us  ratio %.3f%s\n",
+                name,
+                tv_seconds * 1e6 / repetitions,
+                raw_seconds * 1e6 / repetitions,
+                ratio,
+                ok ? "" : "  FAILED");
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const double tolerance = 1 < argc ? std::strtod(argv[1], nullptr) : 1.25;
+
+    std::vector<float> floats(size);
+    for (std::size_t i = 0; i < size; ++i)
+        floats[i] = float(i % 1000) * 0.5f;
+    std::vector<float> out(size);
+
+    std::vector<int> ints(size);
+    for (std::size_t i = 0; i < size; ++i)
+        ints[i] = int(i % 1000);
+
+    std::string str(size, 'A');
+    std::string str_out(size + 1, '\0');
+
+    bool ok = true;
+    ok &= compare(
+        "tidy",
+        tolerance,
+        [&] { tv_tidy(floats.data(), size, out.data()); },
+        [&] { raw_tidy(floats.data(), size, out.data()); });
+    ok &= compare(
+        "stateful",
+        tolerance,
+        [&] { tv_stateful(floats.data(), size, out.data(), 3.0f); },
+        [&] { raw_stateful(floats.data(), size, out.data(), 3.0f); });
+    ok &= compare(
+        "subscript",
+        tolerance,
+        [&] { tv_subscript(floats.data(), size, out.data()); },
+        [&] { raw_subscript(floats.data(), size, out.data()); });
+    ok &= compare(
+        "reduce",
+        tolerance,
+        [&] { sink = tv_reduce(ints.data(), size); },
+        [&] { sink = raw_reduce(ints.data(), size); });
+    ok &= compare(
+        "sentinel",
+        tolerance,
+        [&] { sink = (long long)tv_sentinel(str.c_str(), str_out.data()); },
+        [&] { sink = (long long)raw_sentinel(str.c_str(), str_out.data()); });
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
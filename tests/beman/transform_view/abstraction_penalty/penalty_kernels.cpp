@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Pairs of kernels: each tv_<name>() loops over a beman transform_view, and
+// the matching raw_<name>() is the equivalent hand-written loop.
+// check_vectorization.cmake compiles this file and requires the optimizer to
+// vectorize the loops in each pair identically; penalty.bench.cpp requires
+// them to run at the same speed.
+//
+// Each kernel must sit between "// kernel: <name>" and "// end kernel"
+// markers, which is how the vectorizer's remarks are attributed to kernels.
+// A raw kernel whose loop no compiler vectorizes is marked
+// "// kernel: <name> scalar"; every other raw kernel must vectorize.
+
+#include <beman/transform_view/transform_view.hpp>
+
+#include <cstddef>
+#include <ranges>
+#include <span>
+
+#include "penalty_kernels.hpp"
+
+namespace tv26 = beman::transform_view;
+
+namespace {
+
+struct affine_fn {
+    float operator()(float x) const { return x * 2.0f + 1.0f; }
+};
+
+struct scale_fn {
+    float factor;
+    float operator()(float x) const { return x * factor; }
+};
+
+struct widen_fn {
+    long long operator()(int x) const { return (long long)x << 1; }
+};
+
+struct c_str_sentinel {
+    friend bool operator==(const char* p, c_str_sentinel) { return *p == 0; }
+};
+
+} // namespace
+
+// kernel: tv_tidy
+void tv_tidy(const float* in, std::size_t n, float* out) {
+    auto view = tv26::transform_view(std::span(in, n), affine_fn());
+    for (auto it = view.begin(), last = view.end(); it != last; ++it, ++out)
+        *out = *it;
+}
+// end kernel
+
+// kernel: raw_tidy
+void raw_tidy(const float* in, std::size_t n, float* out) {
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = in[i] * 2.0f + 1.0f;
+}
+// end kernel
+
+// kernel: tv_stateful
+void tv_stateful(const float* in, std::size_t n, float* out, float factor) {
+    auto view = tv26::transform_view(std::span(in, n), scale_fn{factor});
+    for (auto it = view.begin(), last = view.end(); it != last; ++it, ++out)
+        *out = *it;
+}
+// end kernel
+
+// kernel: raw_stateful
+void raw_stateful(const float* in, std::size_t n, float* out, float factor) {
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = in[i] * factor;
+}
+// end kernel
+
+// kernel: tv_subscript
+void tv_subscript(const float* in, std::size_t n, float* out) {
+    auto view  = tv26::transform_view(std::span(in, n), affine_fn());
+    auto first = view.begin();
+    for (std::ptrdiff_t i = 0, size = std::ptrdiff_t(n); i < size; ++i)
+        out[i] = first[i];
+}
+// end kernel
+
+// kernel: raw_subscript
+void raw_subscript(const float* in, std::size_t n, float* out) {
+    for (std::ptrdiff_t i = 0, size = std::ptrdiff_t(n); i < size; ++i)
+        out[i] = in[i] * 2.0f + 1.0f;
+}
+// end kernel
+
+// kernel: tv_reduce
+long long tv_reduce(const int* in, std::size_t n) {
+    long long result = 0;
+    for (long long x : tv26::transform_view(std::span(in, n), widen_fn()))
+        result += x;
+    return result;
+}
+// end kernel
+
+// kernel: raw_reduce
+long long raw_reduce(const int* in, std::size_t n) {
+    long long result = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        result += (long long)in[i] << 1;
+    return result;
+}
+// end kernel
+
+// kernel: tv_sentinel
+std::size_t tv_sentinel(const char* str, char* out) {
+    auto view = tv26::transform_view(std::ranges::subrange(str, c_str_sentinel()),
+                                     [](char c) { return char(c | 0x20); });
+    char* first = out;
+    for (char c : view)
+        *out++ = c;
+    return std::size_t(out - first);
+}
+// end kernel
+
+// kernel: raw_sentinel scalar
+std::size_t raw_sentinel(const char* str, char* out) {
+    char* first = out;
+    for (; *str; ++str)
+        *out++ = char(*str | 0x20);
+    return std::size_t(out - first);
+}
+// end kernel
@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef BEMAN_TRANSFORM_VIEW_TESTS_PENALTY_KERNELS_HPP
+#define BEMAN_TRANSFORM_VIEW_TESTS_PENALTY_KERNELS_HPP
+
+#include <cstddef>
+
+// C linkage, so that check_vectorization.cmake can find the kernels' code
+// sizes by name.
+extern "C" {
+
+void tv_tidy(const float* in, std::size_t n, float* out);
+void raw_tidy(const float* in, std::size_t n, float* out);
+
+void tv_stateful(const float* in, std::size_t n, float* out, float factor);
+void raw_stateful(const float* in, std::size_t n, float* out, float factor);
+
+void tv_subscript(const float* in, std::size_t n, float* out);
+void raw_subscript(const float* in, std::size_t n, float* out);
+
+long long tv_reduce(const int* in, std::size_t n);
+long long raw_reduce(const int* in, std::size_t n);
+
+std::size_t tv_sentinel(const char* str, char* out);
+std::size_t raw_sentinel(const char* str, char* out);
+
+} // extern "C"
+
+#endif
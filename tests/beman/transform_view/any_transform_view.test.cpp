@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <array>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#endif
+
+#include <beman/transform_view/any_transform_view.hpp>
+
+namespace tv26 = beman::transform_view;
+
+auto double_lambda = [](int x) { return x * 2.0; };
+
+struct counting_func {
+    int* calls;
+    int  offset;
+
+    long operator()(int x) const {
+        ++*calls;
+        return x + offset;
+    }
+};
+
+struct big_func {
+    std::array<int, 64> table;
+
+    int operator()(int x) const { return table[std::size_t(x) % 64]; }
+};
+
+TEST(any_transform_view_, concepts) {
+    using view_type = tv26::any_transform_view<int, double>;
+    static_assert(std::ranges::view<view_type>);
+    static_assert(std::ranges::random_access_range<view_type>);
+    static_assert(std::ranges::sized_range<view_type>);
+    static_assert(std::ranges::common_range<view_type>);
+    static_assert(!std::ranges::borrowed_range<view_type>);
+}
+
+TEST(any_transform_view_, default_ctor) {
+    tv26::any_transform_view<int, double> view;
+    EXPECT_TRUE(view.empty());
+    EXPECT_EQ(view.begin(), view.end());
+
+    // The bulk operations have nothing to do, and no callable to call.
+    std::vector<double> out(3, 1.0);
+    EXPECT_EQ(view.copy(out).size(), 3u);
+    view.transform({}, out);
+    int calls = 0;
+    view.for_each_chunk([&](std::span<const double>) { ++calls; });
+    EXPECT_EQ(calls, 0);
+    EXPECT_EQ(out, std::vector<double>(3, 1.0));
+}
+
+TEST(any_transform_view_, element_wise) {
+    std::vector<int>                      ints = {1, 2, 3, 4};
+    tv26::any_transform_view<int, double> view(ints, double_lambda);
+
+    EXPECT_EQ(view.size(), 4u);
+    EXPECT_EQ(view[0], 2.0);
+    EXPECT_EQ(view.begin()[3], 8.0);
+    EXPECT_EQ(*(view.end() - 2), 6.0);
+
+    std::vector<double> result(view.begin(), view.end());
+    EXPECT_EQ(result, std::vector<double>({2.0, 4.0, 6.0, 8.0}));
+}
+
+TEST(any_transform_view_, bulk_copy) {
+    std::vector<int> ints(1000);
+    for (int i = 0; i < 1000; ++i)
+        ints[std::size_t(i)] = i;
+
+    int                                 calls = 0;
+    tv26::any_transform_view<int, long> view(ints, counting_func{&calls, 5});
+
+    std::vector<long> result(ints.size() + 2, -1);
+    auto              rest = view.copy(result);
+    EXPECT_EQ(rest.size(), 2u);
+    EXPECT_EQ(calls, 1000);
+    for (std::size_t i = 0; i < ints.size(); ++i)
+        EXPECT_EQ(result[i], long(i) + 5);
+    EXPECT_EQ(result[1000], -1);
+}
+
+TEST(any_transform_view_, transform_span) {
+    std::vector<int>                      ints = {1, 2, 3};
+    tv26::any_transform_view<int, double> view(ints, double_lambda);
+
+    int    other[2] = {10, 20};
+    double out[2]   = {};
+    view.transform(other, out);
+    EXPECT_EQ(out[0], 20.0);
+    EXPECT_EQ(out[1], 40.0);
+}
+
+TEST(any_transform_view_, for_each_chunk) {
+    using view_type = tv26::any_transform_view<int, int>;
+    std::vector<int> ints(view_type::chunk_size * 2 + 3, 1);
+
+    view_type view(ints, [](int x) { return x + 1; });
+
+    std::vector<std::size_t> sizes;
+    long                     sum = 0;
+    view.for_each_chunk([&](std::span<const int> chunk) {
+        sizes.push_back(chunk.size());
+        for (int x : chunk)
+            sum += x;
+    });
+    EXPECT_EQ(sizes,
+              std::vector<std::size_t>(
+                  {view_type::chunk_size, view_type::chunk_size, 3}));
+    EXPECT_EQ(sum, long(ints.size()) * 2);
+}
+
+TEST(any_transform_view_, heap_stored_func) {
+    big_func f;
+    for (int i = 0; i < 64; ++i)
+        f.table[std::size_t(i)] = i * i;
+
+    std::vector<int>                   ints = {2, 3, 65};
+    tv26::any_transform_view<int, int> view(ints, f);
+    tv26::any_transform_view<int, int> copy = view;
+    tv26::any_transform_view<int, int> moved(std::move(view));
+
+    std::vector<int> result(3);
+    copy.copy(result);
+    EXPECT_EQ(result, std::vector<int>({4, 9, 1}));
+    EXPECT_EQ(moved[1], 9);
+}
+
+TEST(any_transform_view_, runtime_selection) {
+    std::vector<int> ints = {1, 2, 3};
+
+    auto make = [&](bool negate) -> tv26::any_transform_view<int, int> {
+        if (negate)
+            return {ints, [](int x) { return -x; }};
+        return {ints, [](int x) { return x; }};
+    };
+
+    std::vector<int> result(3);
+    make(true).copy(result);
+    EXPECT_EQ(result, std::vector<int>({-1, -2, -3}));
+    make(false).copy(result);
+    EXPECT_EQ(result, std::vector<int>({1, 2, 3}));
+}
+
+TEST(any_transform_view_, owning_func) {
+    auto                               offset = std::make_shared<int>(7);
+    std::vector<int>                   ints   = {1, 2};
+    tv26::any_transform_view<int, int> view(
+        ints, [offset](int x) { return x + *offset; });
+    {
+        auto copy = view;
+        EXPECT_EQ(offset.use_count(), 3);
+    }
+    EXPECT_EQ(offset.use_count(), 2);
+    EXPECT_EQ(view[1], 9);
+}
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#endif
+
+#include <beman/transform_view/arena.hpp>
+
+namespace tv26 = beman::transform_view;
+
+namespace {
+
+// Counts the allocations that reach the default resource.
+struct counting_resource : std::pmr::memory_resource {
+    int         allocations = 0;
+    std::size_t bytes       = 0;
+
+  private:
+    void* do_allocate(std::size_t n, std::size_t alignment) override {
+        ++allocations;
+        bytes += n;
+        return std::pmr::new_delete_resource()->allocate(n, alignment);
+    }
+    void do_deallocate(void* p, std::size_t n, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, n, alignment);
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+bool aligned(const void* p, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+} // namespace
+
+TEST(arena_, bump_allocation) {
+    counting_resource upstream;
+    tv26::bump_arena  arena(4096, tv26::arena_pages::normal, &upstream);
+
+    void* a = arena.allocate(10, 1);
+    void* b = arena.allocate(8, 8);
+    void* c = arena.allocate(64, 64);
+    EXPECT_EQ(upstream.allocations, 1);
+    EXPECT_EQ(static_cast<char*>(a) + 16, b);
+    EXPECT_TRUE(aligned(c, 64));
+    EXPECT_EQ(arena.capacity(), 4096u);
+    EXPECT_TRUE(arena.is_equal(arena));
+}
+
+TEST(arena_, reset_reuses_blocks) {
+    counting_resource upstream;
+    tv26::bump_arena  arena(4096, tv26::arena_pages::normal, &upstream);
+
+    void* first  = arena.allocate(3000, 8);
+    void* second = arena.allocate(3000, 8);
+    void* big    = arena.allocate(10000, 8); // Larger than a block.
+    EXPECT_EQ(upstream.allocations, 3);
+
+    arena.reset();
+    EXPECT_EQ(arena.allocate(3000, 8), first);
+    EXPECT_EQ(arena.allocate(3000, 8), second);
+    EXPECT_EQ(arena.allocate(10000, 8), big);
+    EXPECT_EQ(upstream.allocations, 3);
+
+    arena.release();
+    EXPECT_EQ(arena.capacity(), 0u);
+    EXPECT_NE(arena.allocate(1, 1), nullptr);
+    EXPECT_EQ(upstream.allocations, 4);
+}
+
+TEST(arena_, huge_pages) {
+    tv26::bump_arena arena(1000, tv26::arena_pages::huge);
+    void*            p = arena.allocate(100, 16);
+    EXPECT_TRUE(aligned(p, tv26::bump_arena::huge_page_size));
+    EXPECT_EQ(arena.capacity(), tv26::bump_arena::huge_page_size);
+    EXPECT_NE(arena.allocate(3 * tv26::bump_arena::huge_page_size, 16),
+              nullptr);
+    EXPECT_EQ(arena.capacity(), 5 * tv26::bump_arena::huge_page_size);
+}
+
+TEST(arena_, to_arena_span) {
+    counting_resource upstream;
+    tv26::bump_arena  arena(1 << 16, tv26::arena_pages::normal, &upstream);
+
+    std::vector<int> v{1, 2, 3, 4, 5};
+    std::span<int>   s =
+        tv26::to_arena(v | tv26::views::transform([](int x) { return x * x; }),
+                       arena);
+    EXPECT_EQ(s.size(), 5u);
+    EXPECT_TRUE(std::ranges::equal(s, std::vector<int>{1, 4, 9, 16, 25}));
+    EXPECT_EQ(upstream.allocations, 1);
+
+    // Elements that are not trivially copyable, from a non-contiguous base.
+    std::list<int> l{1, 2};
+    auto           half  = [](int x) { return std::pair(x, x / 2.0); };
+    auto           pairs =
+        tv26::to_arena(l | tv26::views::transform(half), arena);
+    EXPECT_EQ(pairs[1], (std::pair<int, double>(2, 1.0)));
+
+    EXPECT_TRUE(tv26::to_arena(std::views::iota(0, 0), arena).empty());
+    EXPECT_EQ(upstream.allocations, 1);
+}
+
+TEST(arena_, to_arena_containers) {
+    tv26::bump_arena arena;
+
+    std::vector<int> v{1, 2, 3};
+    auto             doubled = tv26::to_arena<std::pmr::vector<int> >(
+        v | tv26::views::transform([](int x) { return 2 * x; }), arena);
+    EXPECT_EQ(doubled.get_allocator().resource(), &arena);
+    EXPECT_EQ(doubled.capacity(), 3u);
+    EXPECT_TRUE(std::ranges::equal(doubled, std::vector<int>{2, 4, 6}));
+
+    std::string s = "Hello";
+    auto        upper = tv26::to_arena<std::pmr::string>(
+        s | tv26::views::transform(
+                [](char c) { return c >= 'a' && c <= 'z' ? char(c - 32) : c; }),
+        arena);
+    EXPECT_EQ(upper, "HELLO");
+    EXPECT_EQ(upper.get_allocator().resource(), &arena);
+
+    // Strings are not trivially destructible, so they come back in a pmr
+    // container rather than a span.
+    auto line    = [](int i) { return std::string(40, char('a' + i)); };
+    auto strings = tv26::to_arena<std::pmr::vector<std::pmr::string> >(
+        std::views::iota(0, 3) | tv26::views::transform(line), arena);
+    EXPECT_EQ(strings[2], std::pmr::string(40, 'c'));
+    EXPECT_EQ(strings[2].get_allocator().resource(), &arena);
+}
+
+TEST(arena_, thread_arena) {
+    tv26::bump_arena* main_arena  = &tv26::thread_arena();
+    tv26::bump_arena* other_arena = nullptr;
+    std::thread([&] { other_arena = &tv26::thread_arena(); }).join();
+    EXPECT_EQ(main_arena, &tv26::thread_arena());
+    EXPECT_NE(main_arena, other_arena);
+
+    auto s = tv26::to_arena(std::views::iota(0, 4), tv26::thread_arena());
+    EXPECT_EQ(s[3], 3);
+    tv26::thread_arena().reset();
+}
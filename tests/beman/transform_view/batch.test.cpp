@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <span>
+#include <vector>
+#endif
+
+#include <beman/transform_view/batch.hpp>
+#include <beman/transform_view/reduce.hpp>
+
+namespace tv26 = beman::transform_view;
+
+struct batch_square {
+    int* scalar_calls;
+    int* batch_calls;
+
+    long operator()(int x) const {
+        ++*scalar_calls;
+        return long(x) * x;
+    }
+    void operator()(std::span<const int> in, std::span<long> out) const {
+        ++*batch_calls;
+        for (std::size_t i = 0; i < in.size(); ++i)
+            out[i] = long(in[i]) * in[i];
+    }
+};
+
+struct tidy_batch_negate {
+    int operator()(int x) const { return -x; }
+    void operator()(std::span<const int> in, std::span<int> out) const {
+        for (std::size_t i = 0; i < in.size(); ++i)
+            out[i] = -in[i];
+    }
+};
+
+struct batch_square_fixture : ::testing::Test {
+    int scalar_calls = 0;
+    int batch_calls  = 0;
+
+    batch_square square() { return {&scalar_calls, &batch_calls}; }
+};
+
+constexpr std::size_t n_batches(std::size_t n) {
+    const std::size_t size = tv26::batch_bytes / sizeof(long);
+    return (n + size - 1) / size;
+}
+
+std::vector<int> iota_vector(std::size_t n) {
+    std::vector<int> result(n);
+    std::iota(result.begin(), result.end(), 0);
+    return result;
+}
+
+TEST(batch_, detection) {
+    auto identity         = [](int x) { return x; };
+    using contiguous_view = decltype(std::declval<std::vector<int>&>() |
+                                     tv26::views::transform(batch_square{}));
+    using deque_view      = decltype(std::declval<std::deque<int>&>() |
+                                tv26::views::transform(batch_square{}));
+    using scalar_view     = decltype(std::declval<std::vector<int>&>() |
+                                 tv26::views::transform(identity));
+    static_assert(tv26::batch_invocable<batch_square, int, long>);
+    static_assert(tv26::detail::batch_view<contiguous_view>);
+    static_assert(tv26::detail::batch_view<const contiguous_view>);
+    static_assert(!tv26::detail::batch_view<deque_view>);
+    static_assert(!tv26::detail::batch_view<scalar_view>);
+}
+
+TEST_F(batch_square_fixture, scalar_access) {
+    std::vector<int> ints = iota_vector(10);
+    auto             view = ints | tv26::views::transform(square());
+    EXPECT_EQ(*std::ranges::next(view.begin(), 3), 9);
+    EXPECT_EQ(scalar_calls, 1);
+    EXPECT_EQ(batch_calls, 0);
+}
+
+TEST_F(batch_square_fixture, copy_contiguous) {
+    const std::size_t n    = 5000;
+    std::vector<int>  ints = iota_vector(n);
+    auto              view = ints | tv26::views::transform(square());
+
+    std::vector<long> out(n + 1, -1);
+    auto              last = tv26::batch_copy(view, out.begin());
+    EXPECT_EQ(last, out.begin() + n);
+    for (std::size_t i = 0; i < n; ++i)
+        EXPECT_EQ(out[i], long(i) * long(i));
+    EXPECT_EQ(out[n], -1);
+    EXPECT_EQ(scalar_calls, 0);
+    EXPECT_EQ(batch_calls, int(n_batches(n)));
+}
+
+TEST_F(batch_square_fixture, copy_buffered) {
+    const std::size_t n    = 3000;
+    std::vector<int>  ints = iota_vector(n);
+    auto              view = ints | tv26::views::transform(square());
+
+    std::list<long> out;
+    tv26::batch_copy(view, std::back_inserter(out));
+    ASSERT_EQ(out.size(), n);
+    EXPECT_EQ(out.back(), long(n - 1) * long(n - 1));
+    EXPECT_EQ(scalar_calls, 0);
+    EXPECT_EQ(batch_calls, int(n_batches(n)));
+}
+
+TEST_F(batch_square_fixture, copy_fallback) {
+    std::deque<int> ints = {1, 2, 3};
+    auto            view = ints | tv26::views::transform(square());
+
+    std::vector<long> out(3);
+    tv26::batch_copy(view, out.begin());
+    EXPECT_EQ(out, std::vector<long>({1, 4, 9}));
+    EXPECT_EQ(scalar_calls, 3);
+    EXPECT_EQ(batch_calls, 0);
+}
+
+TEST_F(batch_square_fixture, for_each) {
+    const std::size_t n    = 5000;
+    std::vector<int>  ints = iota_vector(n);
+    auto              view = ints | tv26::views::transform(square());
+
+    long sum = 0;
+    tv26::batch_for_each(view, [&sum](long x) { sum += x; });
+    EXPECT_EQ(sum, long(n - 1) * long(n) * long(2 * n - 1) / 6);
+    EXPECT_EQ(scalar_calls, 0);
+    EXPECT_EQ(batch_calls, int(n_batches(n)));
+}
+
+TEST_F(batch_square_fixture, to) {
+    std::vector<int> ints = iota_vector(4);
+    auto             view = ints | tv26::views::transform(square());
+
+    EXPECT_EQ(tv26::batch_to<std::vector<long> >(view),
+              std::vector<long>({0, 1, 4, 9}));
+    EXPECT_EQ(tv26::batch_to<std::list<long> >(view),
+              std::list<long>({0, 1, 4, 9}));
+    EXPECT_EQ(scalar_calls, 0);
+    EXPECT_EQ(batch_calls, 2);
+}
+
+TEST_F(batch_square_fixture, reduce) {
+    const std::size_t n    = 5000;
+    std::vector<int>  ints = iota_vector(n);
+    auto              view = ints | tv26::views::transform(square());
+
+    const long expected = long(n - 1) * long(n) * long(2 * n - 1) / 6;
+    EXPECT_EQ(tv26::reduce(view, 0L), expected);
+    EXPECT_EQ(tv26::reduce(tv26::unordered, view, 0L), expected);
+    EXPECT_EQ(scalar_calls, 0);
+    EXPECT_EQ(batch_calls, 2 * int(n_batches(n)));
+}
+
+TEST(batch_, tidy) {
+    std::vector<int> ints = {1, 2, 3};
+    auto             view = ints | tv26::views::transform(tidy_batch_negate{});
+    static_assert(tv26::detail::batch_view<decltype(view)>);
+    EXPECT_EQ(tv26::batch_to<std::vector<int> >(view),
+              std::vector<int>({-1, -2, -3}));
+    EXPECT_EQ(tv26::reduce(view, 0), -6);
+}
+
+TEST(batch_, empty) {
+    std::vector<int> ints;
+    auto             view = ints | tv26::views::transform(tidy_batch_negate{});
+    EXPECT_TRUE(tv26::batch_to<std::vector<int> >(view).empty());
+    EXPECT_EQ(tv26::reduce(view, 7), 7);
+}
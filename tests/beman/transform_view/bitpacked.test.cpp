@@ -0,0 +1,195 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+#endif
+
+#include <beman/transform_view/batch.hpp>
+#include <beman/transform_view/bitpacked.hpp>
+#include <beman/transform_view/reduce.hpp>
+
+namespace tv26 = beman::transform_view;
+
+namespace {
+
+// Returns n pseudo-random K-bit values.
+std::vector<std::uint64_t> make_values(std::size_t k, std::size_t n) {
+    std::vector<std::uint64_t> values(n);
+    std::uint64_t              x = 88172645463325252ull + k;
+    for (std::uint64_t& v : values) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        v = k == 64 ? x : x & ((std::uint64_t(1) << k) - 1);
+    }
+    return values;
+}
+
+// Packs values of k bits each, with `padding` extra bytes at the end.
+std::vector<std::byte> pack(const std::vector<std::uint64_t>& values,
+                            std::size_t                       k,
+                            std::size_t                       padding = 0) {
+    std::vector<std::byte> bytes((values.size() * k + 7) / 8 + padding);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        for (std::size_t b = 0; b < k; ++b) {
+            if ((values[i] >> b) & 1) {
+                const std::size_t bit = i * k + b;
+                bytes[bit / 8] |= std::byte(1u << (bit % 8));
+            }
+        }
+    }
+    return bytes;
+}
+
+template <std::size_t K>
+void check_width(std::size_t n, std::size_t padding) {
+    const auto values = make_values(K, n);
+    const auto bytes  = pack(values, K, padding);
+    auto       view   = tv26::views::bitpacked<K>(bytes, n);
+    ASSERT_EQ(view.size(), n);
+
+    // One element at a time, forwards and by index.
+    std::size_t i = 0;
+    for (auto v : view) {
+        ASSERT_EQ(v, values[i]) << K << ' ' << i;
+        ++i;
+    }
+    EXPECT_EQ(i, n);
+    for (std::size_t j = n; j-- > 0;)
+        ASSERT_EQ(view[j], values[j]) << K << ' ' << j;
+
+    // A block at a time.
+    using T = typename tv26::bitpacked_view<K>::value_type;
+    const auto all = tv26::batch_to<std::vector<T> >(view);
+    ASSERT_EQ(all.size(), n);
+    for (std::size_t j = 0; j < n; ++j)
+        ASSERT_EQ(all[j], values[j]) << K << ' ' << j;
+
+    // Through a transform.
+    std::vector<std::uint64_t> doubled(n);
+    tv26::batch_copy(view | tv26::views::transform([](T x) {
+                         return std::uint64_t(x) * 2;
+                     }),
+                     doubled.begin());
+    for (std::size_t j = 0; j < n; ++j)
+        ASSERT_EQ(doubled[j], values[j] * 2) << K << ' ' << j;
+}
+
+template <std::size_t... K>
+void check_widths(std::size_t n, std::size_t padding) {
+    (check_width<K>(n, padding), ...);
+}
+
+#if BEMAN_TRANSFORM_VIEW_BITPACKED_AVX2
+template <std::size_t K>
+void check_avx2_block() {
+    const auto values = make_values(K, tv26::bitpacked_block);
+    const auto bytes  = pack(values, K, 16);
+    std::array<std::uint32_t, tv26::bitpacked_block> simd;
+    std::array<std::uint32_t, tv26::bitpacked_block> scalar;
+    tv26::detail::unpack_block_avx2<K>(bytes.data(), simd.data());
+    tv26::detail::unpack_block_scalar<K>(bytes.data(), scalar.data());
+    EXPECT_EQ(simd, scalar) << K;
+}
+
+template <std::size_t... K>
+void check_avx2_blocks(std::index_sequence<K...>) {
+    (check_avx2_block<K + 1>(), ...);
+}
+#endif
+
+} // namespace
+
+TEST(bitpacked_, concepts) {
+    using V = tv26::bitpacked_view<12>;
+    static_assert(std::ranges::random_access_range<V>);
+    static_assert(std::ranges::sized_range<V>);
+    static_assert(std::ranges::common_range<V>);
+    static_assert(std::ranges::borrowed_range<V>);
+    static_assert(std::ranges::view<V>);
+    static_assert(std::same_as<std::ranges::range_value_t<V>, std::uint32_t>);
+    static_assert(
+        std::same_as<std::ranges::range_value_t<tv26::bitpacked_view<40> >,
+                     std::uint64_t>);
+    static_assert(tv26::detail::chunked_range<V>);
+    static_assert(tv26::detail::chunked_range<decltype(
+                      V() | tv26::views::transform([](std::uint32_t x) {
+                          return x + 1;
+                      }))>);
+}
+
+TEST(bitpacked_, widths) {
+    for (std::size_t n : {0, 1, 63, 64, 65, 1000, 4096 + 17}) {
+        for (std::size_t padding : {0, 32}) {
+            check_widths<1, 2, 3, 5, 7, 8, 9, 12, 13, 16, 17, 23, 24>(n,
+                                                                     padding);
+            check_widths<25, 31, 32, 33, 47, 56, 57, 58, 63, 64>(n, padding);
+        }
+    }
+}
+
+#if BEMAN_TRANSFORM_VIEW_BITPACKED_AVX2
+TEST(bitpacked_, avx2_matches_scalar) {
+    // Runs the AVX2 unpacker directly, whichever one the view would choose.
+    if (!tv26::detail::bitpacked_has_avx2())
+        GTEST_SKIP() << "no AVX2";
+    check_avx2_blocks(std::make_index_sequence<24>());
+}
+#endif
+
+TEST(bitpacked_, chunks) {
+    const auto values = make_values(11, 1000);
+    const auto bytes  = pack(values, 11);
+    auto       view   = tv26::views::bitpacked<11>(bytes, 1000);
+    for (std::size_t max : {1, 10, 64, 100, 200, 100000}) {
+        std::size_t offset = 0;
+        view.for_each_chunk(max, [&](std::span<const std::uint32_t> chunk) {
+            EXPECT_LE(chunk.size(), max);
+            EXPECT_LE(chunk.size(), tv26::bitpacked_view<11>::chunk_capacity);
+            for (std::size_t j = 0; j < chunk.size(); ++j)
+                ASSERT_EQ(chunk[j], values[offset + j]);
+            offset += chunk.size();
+        });
+        EXPECT_EQ(offset, 1000u);
+    }
+}
+
+TEST(bitpacked_, reduce) {
+    const auto    values   = make_values(20, 5000);
+    const auto    bytes    = pack(values, 20);
+    std::uint64_t expected = 0;
+    for (std::uint64_t v : values)
+        expected += v * v;
+    auto squares = tv26::views::bitpacked<20>(bytes, values.size()) |
+                   tv26::views::transform(
+                       [](std::uint32_t x) { return std::uint64_t(x) * x; });
+    EXPECT_EQ(tv26::reduce(squares, std::uint64_t(0), std::plus<>()),
+              expected);
+    EXPECT_EQ(tv26::reduce(tv26::unordered,
+                           squares,
+                           std::uint64_t(0),
+                           std::plus<>()),
+              expected);
+}
+
+TEST(bitpacked_, borrowed_iterators) {
+    const auto values = make_values(6, 100);
+    const auto bytes  = pack(values, 6);
+    auto it = std::ranges::max_element(tv26::views::bitpacked<6>(bytes, 100));
+    EXPECT_EQ(*it, std::ranges::max(values));
+    EXPECT_EQ(it[0], *it);
+}
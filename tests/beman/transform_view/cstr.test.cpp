@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <ranges>
+#include <string>
+#include <vector>
+#endif
+
+#include <beman/transform_view/batch.hpp>
+#include <beman/transform_view/cstr.hpp>
+#include <beman/transform_view/reduce.hpp>
+
+namespace tv26 = beman::transform_view;
+
+namespace {
+
+struct upper_fn {
+    char operator()(char c) const {
+        return c >= 'a' && c <= 'z' ? char(c - 'a' + 'A') : c;
+    }
+};
+
+// Counts its calls, so that it is not tidy.
+struct counting_fn {
+    int* calls;
+    int  operator()(char16_t c) const {
+        ++*calls;
+        return int(c);
+    }
+};
+
+// Returns a string of n characters, none of them null.
+template <typename CharT>
+std::basic_string<CharT> make_text(std::size_t n) {
+    std::basic_string<CharT> s(n, CharT());
+    for (std::size_t i = 0; i < n; ++i)
+        s[i] = CharT('a' + i % 26);
+    return s;
+}
+
+// Checks a cstr_view of every length up to 200 at every offset up to 64 in
+// a buffer, with the bytes after the terminator non-null.
+template <typename CharT>
+void check_all_alignments() {
+    std::vector<CharT> buffer(300, CharT('x'));
+    for (std::size_t offset = 0; offset < 64; ++offset) {
+        for (std::size_t n = 0; n < 200; ++n) {
+            std::fill(buffer.begin(), buffer.end(), CharT('x'));
+            buffer[offset + n] = CharT();
+            const CharT* s = buffer.data() + offset;
+
+            std::vector<CharT> out(n + 1, CharT('?'));
+            const auto last =
+                tv26::batch_copy(tv26::views::cstr(s), out.data());
+            ASSERT_EQ(last, out.data() + n) << offset << ' ' << n;
+            ASSERT_TRUE(std::equal(out.begin(),
+                                   out.begin() + std::ptrdiff_t(n),
+                                   buffer.begin() + std::ptrdiff_t(offset)));
+            ASSERT_EQ(out[n], CharT('?'));
+        }
+    }
+}
+
+#if BEMAN_TRANSFORM_VIEW_CSTR_AVX2
+// Checks that the AVX2 and SSE2 scanners agree on every length up to 200 at
+// every offset up to 64, for limits below, at and above the length.
+template <typename CharT>
+void check_avx2_scanner() {
+    std::vector<CharT> buffer(300, CharT('x'));
+    for (std::size_t offset = 0; offset < 64; ++offset) {
+        for (std::size_t n = 0; n < 200; ++n) {
+            std::fill(buffer.begin(), buffer.end(), CharT('x'));
+            buffer[offset + n] = CharT();
+            const CharT* s = buffer.data() + offset;
+            for (std::size_t max : {n / 2, n, n + 1, n + 40}) {
+                const std::size_t simd =
+                    tv26::detail::scan_terminator_avx2(s, max);
+                const std::size_t sse2 =
+                    tv26::detail::scan_terminator_sse2(s, max);
+                ASSERT_EQ(simd, sse2) << offset << ' ' << n << ' ' << max;
+                ASSERT_EQ(simd, (std::min)(n, max));
+            }
+        }
+    }
+}
+#endif
+
+} // namespace
+
+TEST(cstr_, concepts) {
+    using V = tv26::cstr_view<char>;
+    static_assert(std::ranges::contiguous_range<V>);
+    static_assert(!std::ranges::sized_range<V>);
+    static_assert(std::ranges::view<V>);
+    static_assert(std::ranges::borrowed_range<V>);
+    static_assert(std::same_as<std::ranges::iterator_t<V>, const char*>);
+    static_assert(
+        std::same_as<std::ranges::sentinel_t<V>, tv26::cstr_sentinel>);
+}
+
+TEST(cstr_, elementwise_iteration) {
+    const char* s = "hello";
+    std::string out;
+    for (char c : tv26::views::cstr(s))
+        out += c;
+    EXPECT_EQ(out, "hello");
+    EXPECT_TRUE(tv26::views::cstr("").empty());
+    EXPECT_EQ(std::ranges::distance(tv26::views::cstr(u"wide")), 4);
+}
+
+TEST(cstr_, constexpr) {
+    static_assert(std::ranges::distance(tv26::views::cstr("abc")) == 3);
+    static_assert(tv26::reduce(tv26::views::cstr("abc"), 0) ==
+                  'a' + 'b' + 'c');
+}
+
+TEST(cstr_, all_alignments) {
+    check_all_alignments<char>();
+    check_all_alignments<char16_t>();
+    check_all_alignments<char32_t>();
+}
+
+#if BEMAN_TRANSFORM_VIEW_CSTR_AVX2
+TEST(cstr_, avx2_matches_sse2) {
+    // Runs the AVX2 scanner directly, whichever one the view would choose.
+    if (!tv26::detail::cstr_has_avx2())
+        GTEST_SKIP() << "no AVX2";
+    check_avx2_scanner<char>();
+    check_avx2_scanner<char16_t>();
+    check_avx2_scanner<char32_t>();
+}
+#endif
+
+TEST(cstr_, long_strings) {
+    // Longer than a chunk, and ending at various points around chunk ends.
+    for (std::size_t n : {std::size_t(16 * 1024 - 1),
+                          std::size_t(16 * 1024),
+                          std::size_t(16 * 1024 + 1),
+                          std::size_t(100000)}) {
+        const std::string s = make_text<char>(n);
+        std::string       out;
+        tv26::batch_copy(tv26::views::cstr(s.c_str()),
+                         std::back_inserter(out));
+        EXPECT_EQ(out, s);
+    }
+}
+
+TEST(cstr_, ends_at_page_boundary) {
+    // A terminator at the last byte of a page, or just after it.
+    constexpr std::size_t page = 4096;
+    std::vector<char>     buffer(3 * page, 'x');
+    char*                 base = buffer.data();
+    char* const           aligned =
+        base + (page - reinterpret_cast<std::uintptr_t>(base) % page) % page;
+    for (std::size_t n : {page - 1, page, page - 17, page + 15}) {
+        std::fill(buffer.begin(), buffer.end(), 'x');
+        aligned[n] = '\0';
+        std::string out;
+        tv26::batch_for_each(tv26::views::cstr(aligned + 3),
+                             [&out](char c) { out += c; });
+        EXPECT_EQ(out.size(), n - 3);
+    }
+}
+
+TEST(cstr_, transform) {
+    const std::string s = make_text<char>(50000);
+    auto view =
+        tv26::transform_view(tv26::views::cstr(s.c_str()), upper_fn{});
+    std::string out(s.size(), '\0');
+    EXPECT_EQ(tv26::batch_copy(view, out.begin()), out.end());
+    std::string expected;
+    for (char c : s)
+        expected += upper_fn{}(c);
+    EXPECT_EQ(out, expected);
+
+    EXPECT_EQ(tv26::batch_to<std::list<char> >(view).size(), s.size());
+
+    // Element by element, through the sentinel.
+    std::string one_by_one;
+    for (char c : view)
+        one_by_one += c;
+    EXPECT_EQ(one_by_one, expected);
+}
+
+TEST(cstr_, reduce) {
+    const std::u16string s = make_text<char16_t>(40000);
+    int                  calls = 0;
+    auto view = tv26::transform_view(tv26::views::cstr(s.c_str()),
+                                     counting_fn{&calls});
+    long expected = 0;
+    for (char16_t c : s)
+        expected += c;
+    EXPECT_EQ(tv26::reduce(view, 0L), expected);
+    EXPECT_EQ(calls, int(s.size()));
+    EXPECT_EQ(tv26::reduce(tv26::unordered, view, 0L), expected);
+    EXPECT_EQ(calls, 2 * int(s.size()));
+}
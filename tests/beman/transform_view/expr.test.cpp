@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <deque>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <vector>
+#endif
+
+#include <beman/transform_view/expr.hpp>
+
+namespace tv26 = beman::transform_view;
+
+TEST(expr_, fuses_into_one_view) {
+    std::vector<double> a{1, 2, 3, 4};
+    std::vector<double> b{10, 20, 30, 40};
+    std::vector<double> c{2, 2, 3, 3};
+
+    auto e = tv26::as_expr(a) + tv26::as_expr(b) * tv26::as_expr(c);
+
+    // One transform_view over the three leaves, with a stateless callable.
+    using leaves_t = decltype(e.base());
+    static_assert(std::tuple_size_v<std::remove_cvref_t<
+                      decltype(std::declval<leaves_t>().leaves())> > == 3);
+    static_assert(std::is_empty_v<std::remove_cvref_t<
+                      decltype(tv26::detail::view_access::fun(e))> >);
+    static_assert(std::ranges::random_access_range<decltype(e)>);
+    static_assert(std::ranges::sized_range<decltype(e)>);
+    static_assert(
+        std::same_as<std::ranges::range_value_t<decltype(e)>, double>);
+
+    EXPECT_EQ(e.size(), 4u);
+    EXPECT_EQ(e[0], 21);
+    EXPECT_EQ(e[3], 124);
+    EXPECT_TRUE(std::ranges::equal(e, std::vector<double>{21, 42, 93, 124}));
+}
+
+TEST(expr_, scalars_and_unary_minus) {
+    std::vector<int> a{1, 2, 3};
+
+    auto e = 2 * tv26::as_expr(a) - 1;
+    EXPECT_TRUE(std::ranges::equal(e, std::vector<int>{1, 3, 5}));
+
+    auto f = -(tv26::as_expr(a) / 2.0) + 10;
+    EXPECT_TRUE(std::ranges::equal(f, std::vector<double>{9.5, 9, 8.5}));
+}
+
+TEST(expr_, size_is_shortest_leaf) {
+    std::vector<int> a{1, 2, 3, 4, 5};
+    std::vector<int> b{1, 1, 1};
+
+    auto e = tv26::as_expr(a) - tv26::as_expr(b);
+    EXPECT_EQ(e.size(), 3u);
+    EXPECT_TRUE(std::ranges::equal(e, std::vector<int>{0, 1, 2}));
+}
+
+TEST(expr_, lazy) {
+    std::vector<int> a{1, 2, 3};
+    auto             e = tv26::as_expr(a) * 10;
+    a[1]               = 7;
+    EXPECT_EQ(e[1], 70);
+}
+
+TEST(expr_, leaf_only) {
+    std::vector<int> a{1, 2, 3};
+    auto             e = tv26::as_expr(a);
+    static_assert(std::same_as<std::ranges::range_reference_t<decltype(e)>,
+                               int&>);
+    e[0] = 5;
+    EXPECT_EQ(a[0], 5);
+
+    auto i = tv26::as_expr(std::views::iota(0, 3));
+    static_assert(
+        std::same_as<std::ranges::range_reference_t<decltype(i)>, int>);
+    EXPECT_EQ(i[2], 2);
+}
+
+TEST(expr_, borrowed) {
+    std::vector<int> a{1, 2, 3};
+    std::vector<int> b{4, 5, 6};
+    std::span<int>   sa(a), sb(b);
+
+    auto e = tv26::as_expr(sa) + tv26::as_expr(sb) * 2;
+    static_assert(std::ranges::borrowed_range<decltype(e)>);
+
+    auto owning = tv26::as_expr(std::vector<int>{1, 2}) + tv26::as_expr(sa);
+    static_assert(!std::ranges::borrowed_range<decltype(owning)>);
+    EXPECT_TRUE(std::ranges::equal(owning, std::vector<int>{2, 4}));
+
+    auto it = std::ranges::find(tv26::as_expr(sa) * 3, 6);
+    static_assert(!std::same_as<decltype(it), std::ranges::dangling>);
+    EXPECT_EQ(*it, 6);
+}
+
+TEST(expr_, evaluate) {
+    std::vector<float> a(1000), b(1000);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        a[i] = float(i);
+        b[i] = float(2 * i);
+    }
+    auto e = (tv26::as_expr(a) + tv26::as_expr(b)) * 0.5f;
+
+    std::vector<float> out(1000);
+    auto               end = tv26::evaluate(e, out.begin());
+    EXPECT_EQ(end, out.end());
+    for (std::size_t i = 0; i < out.size(); ++i)
+        ASSERT_EQ(out[i], 1.5f * float(i));
+
+    // Non-contiguous leaves and outputs.
+    std::deque<float> d(a.begin(), a.begin() + 5);
+    std::vector<float> r;
+    tv26::evaluate(tv26::as_expr(d) - 1, std::back_inserter(r));
+    EXPECT_EQ(r, (std::vector<float>{-1, 0, 1, 2, 3}));
+}
+
+TEST(expr_, composes_with_views) {
+    std::vector<int> a{1, 2, 3, 4};
+    auto             e = (tv26::as_expr(a) * 2) |
+             tv26::views::transform([](int x) { return x + 1; });
+    EXPECT_TRUE(std::ranges::equal(e, std::vector<int>{3, 5, 7, 9}));
+}
+
+namespace {
+template <typename L, typename R>
+concept can_add = requires(L l, R r) { l + r; };
+} // namespace
+
+TEST(expr_, operators_need_an_expr) {
+    using expr_t = decltype(tv26::as_expr(std::declval<std::vector<int>&>()));
+    static_assert(can_add<expr_t, expr_t>);
+    static_assert(can_add<expr_t, int>);
+    static_assert(can_add<double, expr_t>);
+    // Plain transform_views and ranges are not expressions.
+    using view_t = decltype(tv26::views::transform(
+        std::declval<std::vector<int>&>(), [](int x) { return x; }));
+    static_assert(!can_add<view_t, int>);
+    static_assert(!can_add<expr_t, std::vector<int> >);
+}
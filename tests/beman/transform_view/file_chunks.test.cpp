@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ranges>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+#endif
+
+#include <beman/transform_view/file_chunks.hpp>
+
+namespace tv26 = beman::transform_view;
+
+namespace {
+
+// A file in the temporary directory, removed on destruction.
+struct temp_file {
+    std::filesystem::path path;
+
+    temp_file(const std::string& name, std::size_t size)
+        : path(std::filesystem::temp_directory_path() /
+               ("beman_transform_view_" + name)) {
+        std::ofstream out(path, std::ios::binary);
+        for (std::size_t i = 0; i < size; ++i)
+            out.put(char(byte_at(i)));
+    }
+    ~temp_file() { std::filesystem::remove(path); }
+
+    static unsigned char byte_at(std::size_t i) {
+        return (unsigned char)(i * 131 + i / 251);
+    }
+};
+
+// Reads the whole file through file_chunks, and checks its contents and
+// chunk sizes.
+void check_file(std::size_t size,
+                std::size_t chunk_size,
+                std::size_t depth,
+                tv26::file_io io) {
+    temp_file file("check_" + std::to_string(size), size);
+    auto      view = tv26::views::file_chunks(file.path, chunk_size, depth, io);
+    EXPECT_EQ(view.file_size(), size);
+
+    std::size_t offset = 0;
+    std::size_t chunks = 0;
+    for (std::span<const std::byte> chunk : view) {
+        ASSERT_EQ(chunk.size(), std::min(chunk_size, size - offset));
+        for (std::size_t i = 0; i < chunk.size(); ++i)
+            ASSERT_EQ(chunk[i], std::byte(temp_file::byte_at(offset + i)));
+        offset += chunk.size();
+        ++chunks;
+    }
+    EXPECT_EQ(offset, size);
+    EXPECT_EQ(chunks, (size + chunk_size - 1) / chunk_size);
+}
+
+} // namespace
+
+TEST(file_chunks_, concepts) {
+    using V = tv26::file_chunks_view;
+    static_assert(std::ranges::input_range<V>);
+    static_assert(!std::ranges::forward_range<V>);
+    static_assert(std::ranges::view<V>);
+    static_assert(std::same_as<std::ranges::range_reference_t<V>,
+                               std::span<const std::byte> >);
+}
+
+TEST(file_chunks_, contents) {
+    for (auto io : {tv26::file_io::automatic, tv26::file_io::threads}) {
+        check_file(0, 4096, 4, io);
+        check_file(1, 4096, 4, io);
+        check_file(4096, 4096, 1, io);
+        check_file(100000, 4096, 4, io);
+        check_file(100000, 1000, 16, io);
+        check_file(1 << 20, 65536, 3, io);
+    }
+}
+
+TEST(file_chunks_, backends) {
+    temp_file file("backends", 10);
+    auto threads = tv26::views::file_chunks(
+        file.path, 4, tv26::file_chunks_view::default_depth,
+        tv26::file_io::threads);
+    EXPECT_FALSE(threads.uses_io_uring());
+#if !BEMAN_TRANSFORM_VIEW_IO_URING
+    EXPECT_FALSE(tv26::views::file_chunks(file.path, 4).uses_io_uring());
+#endif
+}
+
+TEST(file_chunks_, transform) {
+    temp_file file("transform", 300000);
+    auto      sums =
+        tv26::views::file_chunks(file.path, 65536) |
+        tv26::views::transform([](std::span<const std::byte> chunk) {
+            std::uint64_t sum = 0;
+            for (std::byte b : chunk)
+                sum += std::uint64_t(b);
+            return sum;
+        });
+    std::uint64_t total = 0;
+    for (std::uint64_t sum : sums)
+        total += sum;
+
+    std::uint64_t expected = 0;
+    for (std::size_t i = 0; i < 300000; ++i)
+        expected += temp_file::byte_at(i);
+    EXPECT_EQ(total, expected);
+}
+
+TEST(file_chunks_, early_stop) {
+    // Destroying the view with reads in flight must wait for them.
+    temp_file file("early_stop", 1 << 20);
+    for (auto io : {tv26::file_io::automatic, tv26::file_io::threads}) {
+        auto view = tv26::views::file_chunks(file.path, 4096, 8, io);
+        auto it   = view.begin();
+        ++it;
+        EXPECT_EQ((*it).size(), 4096u);
+    }
+    // Never started.
+    auto unused = tv26::views::file_chunks(file.path, 4096);
+    (void)unused;
+}
+
+TEST(file_chunks_, missing_file) {
+    EXPECT_THROW(tv26::views::file_chunks(
+                     std::filesystem::temp_directory_path() /
+                         "beman_transform_view_no_such_file",
+                     4096),
+                 std::system_error);
+}
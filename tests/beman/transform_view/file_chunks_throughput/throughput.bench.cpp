@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Writes a temporary file of the given size in MiB (default 256), and times
+// decoding it a chunk at a time: after synchronous pread() calls, and through
+// views::file_chunks with each of its back ends.  Before each run, the
+// file's pages are dropped from the page cache, so that the reads go to the
+// storage device.
+
+#include <beman/transform_view/file_chunks.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <span>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace tv26 = beman::transform_view;
+
+namespace {
+
+constexpr std::size_t chunk_size = std::size_t(1) << 20;
+
+// Stands in for a decoder: a serial hash of every byte, so that it costs
+// about as much CPU time per byte as a simple parser.
+std::uint64_t decode(std::span<const std::byte> chunk) {
+    std::uint64_t h = 14695981039346656037ull;
+    for (std::byte b : chunk)
+        h = (h ^ std::uint64_t(b)) * 1099511628211ull;
+    return h;
+}
+
+void drop_cache(int fd) {
+    ::fdatasync(fd);
+#if defined(POSIX_FADV_DONTNEED)
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+}
+
+void drop_cache(const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    drop_cache(fd);
+    ::close(fd);
+}
+
+std::uint64_t run_sync(const std::filesystem::path& path) {
+    const int     fd     = ::open(path.c_str(), O_RDONLY);
+    auto          buffer = std::make_unique<std::byte[]>(chunk_size);
+    std::uint64_t result = 0;
+    for (off_t offset = 0;;) {
+        const ssize_t n = ::pread(fd, buffer.get(), chunk_size, offset);
+        if (n <= 0)
+            break;
+        result += decode({buffer.get(), std::size_t(n)});
+        offset += n;
+    }
+    ::close(fd);
+    return result;
+}
+
+std::uint64_t run_chunks(const std::filesystem::path& path, tv26::file_io io) {
+    std::uint64_t result = 0;
+    for (std::uint64_t h :
+         tv26::views::file_chunks(
+             path, chunk_size, tv26::file_chunks_view::default_depth, io) |
+             tv26::views::transform(decode))
+        result += h;
+    return result;
+}
+
+template <typename Func>
+double timed(const std::filesystem::path& path,
+             std::uint64_t&               result,
+             Func                         f) {
+    drop_cache(path);
+    const auto start = std::chrono::steady_clock::now();
+    result           = f();
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t mib =
+        1 < argc ? std::size_t(std::strtoul(argv[1], nullptr, 10)) : 256;
+    const auto path = std::filesystem::temp_directory_path() /
+                      "beman_transform_view_file_chunks_throughput";
+    {
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        if (fd < 0) {
+            std::perror("open");
+            return 1;
+        }
+        auto          buffer = std::make_unique<std::byte[]>(chunk_size);
+        std::uint64_t x      = 88172645463325252ull;
+        for (std::size_t i = 0; i < mib; ++i) {
+            for (std::size_t j = 0; j < chunk_size; ++j) {
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+                buffer[j] = std::byte(x);
+            }
+            if (::write(fd, buffer.get(), chunk_size) !=
+                ssize_t(chunk_size)) {
+                std::perror("write");
+                ::close(fd);
+                return 1;
+            }
+        }
+        drop_cache(fd);
+        ::close(fd);
+    }
+
+    std::uint64_t expected = 0, threads = 0, automatic = 0;
+    const double  sync_seconds = timed(path, expected, [&] {
+        return run_sync(path);
+    });
+    const double  threads_seconds = timed(path, threads, [&] {
+        return run_chunks(path, tv26::file_io::threads);
+    });
+    const double  automatic_seconds = timed(path, automatic, [&] {
+        return run_chunks(path, tv26::file_io::automatic);
+    });
+    const bool io_uring =
+        tv26::views::file_chunks(path, chunk_size).uses_io_uring();
+    std::filesystem::remove(path);
+
+    const auto report = [&](const char* name, double seconds) {
+        std::printf("%-22s %8.1f MiB/s  %.2fx\n",
+                    name,
+                    double(mib) / seconds,
+                    sync_seconds / seconds);
+    };
+    report("synchronous pread", sync_seconds);
+    report("file_chunks threads", threads_seconds);
+    report(io_uring ? "file_chunks io_uring" : "file_chunks automatic",
+           automatic_seconds);
+
+    if (threads != expected || automatic != expected) {
+        std::puts("FAILED: results differ");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// A typical user of transform_view.hpp, compiled by measure_header_cost.cmake
+// to measure what the header costs each translation unit.
+
+#include <beman/transform_view/transform_view.hpp>
+
+namespace tv26 = beman::transform_view;
+
+struct point {
+    int x;
+    int y;
+};
+
+int sum_of_squares(const int* first, const int* last) {
+    int  sum  = 0;
+    auto view = std::ranges::subrange(first, last) |
+                tv26::views::transform([](int x) { return x * x; });
+    for (int x : view)
+        sum += x;
+    return sum;
+}
+
+int sum_of_xs(const point* first, const point* last) {
+    int sum = 0;
+    for (int x : tv26::transform_view(std::ranges::subrange(first, last),
+                                      &point::x))
+        sum += x;
+    return sum;
+}
@@ -0,0 +1,89 @@
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# Compiles SOURCE in the default and the lightweight configuration of
+# transform_view.hpp, and reports the size of the preprocessed translation
+# unit and the fastest of RUNS syntax-only compiles for each.  Fails if the
+# lightweight configuration does not build, or preprocesses to more than the
+# default one.
+#
+# Usage:
+#   cmake -DCOMPILER=<c++> -DFLAGS=<flags separated by |> -DSOURCE=<file>
+#         -DWORK_DIR=<dir> [-DRUNS=<n>] -P measure_header_cost.cmake
+
+foreach(var COMPILER FLAGS SOURCE WORK_DIR)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "measure_header_cost.cmake: ${var} is not set")
+    endif()
+endforeach()
+if(NOT DEFINED RUNS)
+    set(RUNS 5)
+endif()
+
+string(REPLACE "|" ";" flags "${FLAGS}")
+
+foreach(mode default lightweight)
+    # A config_generated.hpp earlier on the include path than the build's own
+    # selects the configuration.
+    if(mode STREQUAL "lightweight")
+        set(enabled 1)
+    else()
+        set(enabled 0)
+    endif()
+    set(config_dir "${WORK_DIR}/${mode}")
+    file(
+        WRITE "${config_dir}/beman/transform_view/config_generated.hpp"
+        "#define BEMAN_TRANSFORM_VIEW_USE_MODULES() 0\n"
+        "#define BEMAN_TRANSFORM_VIEW_LIGHTWEIGHT() ${enabled}\n"
+    )
+    set(mode_flags -I${config_dir} ${flags})
+
+    execute_process(
+        COMMAND "${COMPILER}" ${mode_flags} -E -P "${SOURCE}"
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE preprocessed
+        ERROR_VARIABLE errors
+    )
+    if(NOT result EQUAL 0)
+        message(
+            FATAL_ERROR
+            "Preprocessing ${SOURCE} (${mode}) failed:\n${errors}"
+        )
+    endif()
+    string(LENGTH "${preprocessed}" bytes_${mode})
+    string(REGEX MATCHALL "\n" newlines "${preprocessed}")
+    list(LENGTH newlines lines_${mode})
+
+    set(best_${mode} "")
+    foreach(run RANGE 1 ${RUNS})
+        string(TIMESTAMP start "%s%f")
+        execute_process(
+            COMMAND "${COMPILER}" ${mode_flags} -fsyntax-only "${SOURCE}"
+            RESULT_VARIABLE result
+            ERROR_VARIABLE errors
+        )
+        string(TIMESTAMP stop "%s%f")
+        if(NOT result EQUAL 0)
+            message(
+                FATAL_ERROR
+                "Compiling ${SOURCE} (${mode}) failed:\n${errors}"
+            )
+        endif()
+        math(EXPR elapsed "(${stop} - ${start}) / 1000")
+        if(best_${mode} STREQUAL "" OR elapsed LESS best_${mode})
+            set(best_${mode} ${elapsed})
+        endif()
+    endforeach()
+
+    message(
+        STATUS
+        "${mode}: ${lines_${mode}} lines, ${bytes_${mode}} bytes preprocessed; "
+        "${best_${mode}} ms to compile (best of ${RUNS})"
+    )
+endforeach()
+
+if(bytes_lightweight GREATER bytes_default)
+    message(
+        FATAL_ERROR
+        "The lightweight configuration preprocesses to more than the default"
+    )
+endif()
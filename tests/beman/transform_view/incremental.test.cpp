@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <atomic>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#endif
+
+#include <beman/transform_view/incremental.hpp>
+
+namespace tv26 = beman::transform_view;
+
+namespace {
+
+// Squares its argument, counting its calls.
+struct counted_square {
+    std::atomic<int>* calls;
+
+    long operator()(int x) const {
+        calls->fetch_add(1, std::memory_order_relaxed);
+        return long(x) * x;
+    }
+};
+
+struct throw_on_negative {
+    int operator()(int x) const {
+        if (x < 0)
+            throw std::runtime_error("negative");
+        return x;
+    }
+};
+
+template <typename R>
+void expect_squares(const R& r, const std::vector<int>& in) {
+    ASSERT_EQ(r.size(), in.size());
+    for (std::size_t i = 0; i < in.size(); ++i)
+        ASSERT_EQ(r[i], long(in[i]) * in[i]) << i;
+}
+
+} // namespace
+
+TEST(incremental_, concepts) {
+    using I = tv26::incremental_transform<
+        std::ranges::ref_view<std::vector<int> >,
+        counted_square>;
+    static_assert(std::ranges::contiguous_range<const I>);
+    static_assert(std::ranges::sized_range<const I>);
+    static_assert(
+        std::same_as<std::ranges::range_reference_t<const I>, const long&>);
+}
+
+TEST(incremental_, recomputes_marked_only) {
+    std::vector<int> in(1000);
+    for (std::size_t i = 0; i < in.size(); ++i)
+        in[i] = int(i);
+    std::atomic<int>            calls{0};
+    tv26::incremental_transform out(in, counted_square{&calls});
+    EXPECT_EQ(calls.load(), 1000);
+    expect_squares(out, in);
+
+    calls = 0;
+    out.refresh();
+    EXPECT_EQ(calls.load(), 0);
+
+    for (std::size_t i : {999u, 3u, 500u, 3u, 64u, 63u}) {
+        in[i] = -int(i);
+        out.mark(i);
+    }
+    EXPECT_EQ(out.dirty_count(), 5u);
+    // Reads see the old values until the refresh.
+    EXPECT_EQ(out[3], 9);
+    out.refresh();
+    EXPECT_EQ(calls.load(), 5);
+    EXPECT_EQ(out.dirty_count(), 0u);
+    expect_squares(out, in);
+
+    std::span<const long> values = out.values();
+    EXPECT_EQ(values.data(), out.data());
+    EXPECT_EQ(values.size(), 1000u);
+}
+
+TEST(incremental_, mark_ranges) {
+    std::vector<int> in(300, 1);
+    std::atomic<int> calls{0};
+    tv26::incremental_transform out(in, counted_square{&calls});
+
+    calls = 0;
+    for (std::size_t i = 10; i < 200; ++i)
+        in[i] = int(i);
+    out.mark(10, 200);
+    out.mark(50, 60);
+    out.mark(7, 7);
+    EXPECT_EQ(out.dirty_count(), 190u);
+    out.refresh();
+    EXPECT_EQ(calls.load(), 190);
+    expect_squares(out, in);
+
+    calls = 0;
+    for (int& x : in)
+        x = 2;
+    out.mark_all();
+    EXPECT_EQ(out.dirty_count(), 300u);
+    out.refresh();
+    EXPECT_EQ(calls.load(), 300);
+    expect_squares(out, in);
+}
+
+TEST(incremental_, parallel_refresh) {
+    std::vector<int> in(1 << 16);
+    std::atomic<int> calls{0};
+    tv26::incremental_transform out(in, counted_square{&calls});
+
+    calls              = 0;
+    std::size_t marked = 0;
+    for (std::size_t i = 0; i < in.size(); i += 3) {
+        in[i] = int(i % 1000);
+        out.mark(i);
+        ++marked;
+    }
+    out.refresh(4);
+    EXPECT_EQ(std::size_t(calls.load()), marked);
+    EXPECT_EQ(out.dirty_count(), 0u);
+    expect_squares(out, in);
+
+    // Too little work to split: done on this thread.
+    calls = 0;
+    in[5] = 5;
+    out.mark(5);
+    out.refresh(8);
+    EXPECT_EQ(calls.load(), 1);
+    expect_squares(out, in);
+}
+
+TEST(incremental_, resized_base) {
+    std::vector<int> in = {1, 2, 3};
+    std::atomic<int> calls{0};
+    tv26::incremental_transform out(in, counted_square{&calls});
+    in.push_back(4);
+    out.refresh();
+    EXPECT_EQ(calls.load(), 7);
+    expect_squares(out, in);
+
+    // Marking past the end of the old size is fine once refreshed.
+    in[3] = 10;
+    out.mark(3);
+    out.refresh();
+    expect_squares(out, in);
+}
+
+TEST(incremental_, exception_keeps_marks) {
+    std::vector<int>            in(200, 1);
+    tv26::incremental_transform out(in, throw_on_negative());
+
+    for (std::size_t i : {5u, 70u, 150u})
+        in[i] = 2;
+    in[70] = -1;
+    for (std::size_t i : {5u, 70u, 150u})
+        out.mark(i);
+    EXPECT_THROW(out.refresh(), std::runtime_error);
+    EXPECT_EQ(out[5], 2);
+    EXPECT_EQ(out.dirty_count(), 2u);
+
+    in[70] = 3;
+    out.mark(5);
+    EXPECT_EQ(out.dirty_count(), 3u);
+    out.refresh();
+    EXPECT_EQ(out.dirty_count(), 0u);
+    EXPECT_EQ(out[70], 3);
+    EXPECT_EQ(out[150], 2);
+}
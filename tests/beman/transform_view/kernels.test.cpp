@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <cstdint>
+#include <string>
+#include <vector>
+#endif
+
+#include <beman/transform_view/kernels.hpp>
+
+namespace tv26 = beman::transform_view;
+
+TEST(kernels_, selected_isa) {
+    const auto isa = tv26::kernels::selected_isa();
+#if defined(BEMAN_TRANSFORM_VIEW_HAS_KERNELS)
+    EXPECT_EQ(isa, tv26::kernels::selected_isa());
+#else
+    EXPECT_EQ(isa, tv26::kernels::isa::portable);
+#endif
+}
+
+TEST(kernels_, has_kernel) {
+    static_assert(tv26::kernels::has_kernel<tv26::kernels::negate_fn, float>);
+    static_assert(
+        tv26::kernels::has_kernel<tv26::kernels::square_fn, std::int64_t>);
+    static_assert(
+        tv26::kernels::has_kernel<tv26::kernels::ascii_to_lower_fn, char>);
+    static_assert(
+        !tv26::kernels::has_kernel<tv26::kernels::ascii_to_lower_fn, int>);
+    static_assert(!tv26::kernels::has_kernel<tv26::kernels::abs_fn, short>);
+    static_assert(tv26::detail::tidy_func<tv26::kernels::abs_fn>);
+}
+
+TEST(kernels_, transform) {
+    std::vector<float> in(1001);
+    for (std::size_t i = 0; i < in.size(); ++i)
+        in[i] = float(i) - 500.0f;
+
+    std::vector<float> out(in.size());
+    tv26::kernels::transform(
+        std::span<const float>(in), std::span(out), tv26::kernels::abs);
+    for (std::size_t i = 0; i < in.size(); ++i)
+        EXPECT_EQ(out[i], in[i] < 0 ? -in[i] : in[i]);
+
+    std::vector<std::int32_t> ints = {-3, 0, 7};
+    std::vector<std::int32_t> squares(3);
+    tv26::kernels::transform<tv26::kernels::square_fn>(
+        std::span<const std::int32_t>(ints), std::span(squares));
+    EXPECT_EQ(squares, std::vector<std::int32_t>({9, 0, 49}));
+}
+
+TEST(kernels_, in_place) {
+    std::vector<double> values(1001);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = double(i) - 500.0;
+    tv26::kernels::transform(std::span<const double>(values),
+                             std::span(values),
+                             tv26::kernels::negate);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        ASSERT_EQ(values[i], 500.0 - double(i));
+
+    std::string str = "In Place";
+    tv26::kernels::copy(str | tv26::views::transform(
+                                  tv26::kernels::ascii_to_upper),
+                        str);
+    EXPECT_EQ(str, "IN PLACE");
+}
+
+TEST(kernels_, copy_kernel_view) {
+    std::string str = "Hello, World! 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+    auto view = str | tv26::views::transform(tv26::kernels::ascii_to_lower);
+    static_assert(tv26::kernels::detail::kernel_view<decltype(view)&, char>);
+
+    std::string out(str.size() + 1, '.');
+    auto        rest = tv26::kernels::copy(view, out);
+    EXPECT_EQ(rest.size(), 1u);
+    EXPECT_EQ(out, "hello, world! 0123456789 abcdefghijklmnopqrstuvwxyz.");
+}
+
+TEST(kernels_, copy_other_view) {
+    std::vector<double> doubles = {1.0, -2.0, 3.0};
+
+    auto view = doubles | tv26::views::transform([](double x) { return -x; });
+    static_assert(
+        !tv26::kernels::detail::kernel_view<decltype(view)&, double>);
+
+    std::vector<double> out(3);
+    tv26::kernels::copy(view, out);
+    EXPECT_EQ(out, std::vector<double>({-1.0, 2.0, -3.0}));
+
+    tv26::kernels::copy(doubles | tv26::views::transform(tv26::kernels::negate),
+                        out);
+    EXPECT_EQ(out, std::vector<double>({-1.0, 2.0, -3.0}));
+}
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <algorithm>
+#include <forward_list>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <vector>
+#endif
+
+#include <beman/transform_view/legacy_category.hpp>
+
+namespace tv26 = beman::transform_view;
+
+auto square_lambda = [](int x) { return x * x; };
+
+struct opted_in_square {
+    int operator()(int x) const { return x * x; }
+};
+
+template <>
+constexpr bool tv26::enable_legacy_iterator_category<opted_in_square> = true;
+
+template <typename View>
+using category_t = typename std::iterator_traits<
+    std::ranges::iterator_t<View> >::iterator_category;
+
+TEST(legacy_category_, category) {
+    using vector_view = decltype(std::declval<std::vector<int>&>() |
+                                 tv26::views::transform_legacy(square_lambda));
+    using list_view   = decltype(std::declval<std::list<int>&>() |
+                               tv26::views::transform_legacy(square_lambda));
+    using forward_list_view =
+        decltype(std::declval<std::forward_list<int>&>() |
+                 tv26::views::transform_legacy(square_lambda));
+    using plain_view = decltype(std::declval<std::vector<int>&>() |
+                                tv26::views::transform(square_lambda));
+    using opted_in_view = decltype(std::declval<std::vector<int>&>() |
+                                   tv26::views::transform(opted_in_square()));
+
+    static_assert(
+        std::same_as<category_t<vector_view>, std::random_access_iterator_tag>);
+    static_assert(
+        std::same_as<category_t<list_view>, std::bidirectional_iterator_tag>);
+    static_assert(std::same_as<category_t<forward_list_view>,
+                               std::forward_iterator_tag>);
+    static_assert(
+        std::same_as<category_t<plain_view>, std::input_iterator_tag>);
+    static_assert(std::same_as<category_t<opted_in_view>,
+                               std::random_access_iterator_tag>);
+    static_assert(std::same_as<category_t<const opted_in_view>,
+                               std::random_access_iterator_tag>);
+}
+
+TEST(legacy_category_, tidy) {
+    using fn = tv26::legacy_category_fn<decltype(square_lambda)>;
+    static_assert(tv26::detail::tidy_func<fn>);
+
+    std::vector<int> ints = {1, 2, 3};
+    auto view = ints | tv26::views::transform_legacy(square_lambda);
+    static_assert(std::ranges::borrowed_range<decltype(view)>);
+    EXPECT_EQ(view[2], 9);
+}
+
+TEST(legacy_category_, legacy_algorithms) {
+    std::vector<int> ints = {1, 2, 3, 4};
+    auto             view = ints | tv26::views::transform_legacy(square_lambda);
+
+    EXPECT_EQ(std::distance(view.begin(), view.end()), 4);
+    std::vector<int> squares(view.begin(), view.end());
+    EXPECT_EQ(squares, std::vector<int>({1, 4, 9, 16}));
+    EXPECT_TRUE(std::is_sorted(view.begin(), view.end()));
+    EXPECT_EQ(*std::lower_bound(view.begin(), view.end(), 5), 9);
+}
+
+TEST(legacy_category_, stateful) {
+    std::vector<int> ints   = {1, 2, 3};
+    auto             offset = std::make_unique<int>(10);
+    auto             view   = ints | tv26::views::transform_legacy(
+                                 [p = offset.get()](int x) { return x + *p; });
+    static_assert(std::same_as<category_t<decltype(view)>,
+                               std::random_access_iterator_tag>);
+    EXPECT_EQ(std::vector<int>(view.begin(), view.end()),
+              std::vector<int>({11, 12, 13}));
+}
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#endif
+
+#include <beman/transform_view/batch.hpp>
+#include <beman/transform_view/lut.hpp>
+
+namespace tv26 = beman::transform_view;
+
+struct to_lower_fn {
+    constexpr char operator()(char c) const {
+        return 'A' <= c && c <= 'Z' ? char(c + ('a' - 'A')) : c;
+    }
+};
+
+struct hash_byte_fn {
+    template <typename T>
+    constexpr std::uint8_t operator()(T x) const {
+        std::uint32_t h = std::uint32_t(x) * 2654435761u;
+        return std::uint8_t(h >> 24);
+    }
+};
+
+struct is_space_fn {
+    constexpr bool operator()(char c) const {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+};
+
+struct popcount_fn {
+    constexpr int operator()(std::uint16_t x) const {
+        int n = 0;
+        for (; x; x &= std::uint16_t(x - 1))
+            ++n;
+        return n;
+    }
+};
+
+struct byte_reverse_fn {
+    constexpr std::byte operator()(std::byte b) const {
+        return std::byte(0xff) ^ b;
+    }
+};
+
+TEST(lut_, scalar_matches_func) {
+    constexpr tv26::lut_fn<hash_byte_fn> lut;
+    for (int i = 0; i < 256; ++i) {
+        EXPECT_EQ(lut(std::uint8_t(i)), hash_byte_fn()(std::uint8_t(i)));
+        EXPECT_EQ(lut(char(i)), hash_byte_fn()(char(i)));
+        EXPECT_EQ(lut(std::int8_t(i)), hash_byte_fn()(std::int8_t(i)));
+    }
+    static_assert(lut(std::uint8_t(7)) == hash_byte_fn()(std::uint8_t(7)));
+    static_assert(tv26::lut_fn<byte_reverse_fn>()(std::byte(1)) ==
+                  std::byte(0xfe));
+}
+
+TEST(lut_, constraints) {
+    using lut = tv26::lut_fn<hash_byte_fn>;
+    static_assert(std::invocable<lut, char>);
+    static_assert(std::invocable<lut, std::uint16_t>);
+    static_assert(!std::invocable<lut, int>);
+    static_assert(!std::invocable<lut, bool>);
+    static_assert(tv26::detail::tidy_func<lut>);
+    static_assert(tv26::batch_invocable<lut, char, std::uint8_t>);
+    static_assert(!tv26::batch_invocable<lut, char, char>);
+
+    auto stateful = [n = 1](char c) { return char(c + n); };
+    static_assert(!std::invocable<tv26::views::detail::transform_lut_impl,
+                                  std::string&,
+                                  decltype(stateful)>);
+}
+
+TEST(lut_, view) {
+    std::string str  = "Hello, World";
+    auto        view = str | tv26::views::transform_lut(to_lower_fn());
+    static_assert(std::ranges::random_access_range<decltype(view)>);
+    static_assert(std::ranges::borrowed_range<
+                  decltype(std::string_view(str) |
+                           tv26::views::transform_lut(to_lower_fn()))>);
+    std::string result;
+    for (char c : view)
+        result.push_back(c);
+    EXPECT_EQ(result, "hello, world");
+
+    auto view2 = tv26::views::transform_lut(str, is_space_fn());
+    EXPECT_FALSE(view2[4]);
+    EXPECT_TRUE(view2[6]);
+}
+
+TEST(lut_, bulk) {
+    // Lengths around the vector widths exercise the scalar tail.
+    for (std::size_t n : {0, 1, 15, 16, 17, 31, 32, 33, 100, 1000}) {
+        std::vector<unsigned char> bytes(n);
+        for (std::size_t i = 0; i < n; ++i)
+            bytes[i] = static_cast<unsigned char>(i * 37 + 11);
+        auto view = bytes | tv26::views::transform_lut(hash_byte_fn());
+
+        std::vector<std::uint8_t> out(n);
+        tv26::batch_copy(view, out.begin());
+        for (std::size_t i = 0; i < n; ++i)
+            ASSERT_EQ(out[i], hash_byte_fn()(bytes[i])) << n << ' ' << i;
+    }
+}
+
+TEST(lut_, bulk_all_bytes) {
+    std::vector<char> chars(256 * 4);
+    for (std::size_t i = 0; i < chars.size(); ++i)
+        chars[i] = char(i);
+
+    std::vector<char> lower(chars.size());
+    tv26::batch_copy(chars | tv26::views::transform_lut(to_lower_fn()),
+                     lower.begin());
+    std::vector<bool> spaces;
+    tv26::batch_for_each(chars | tv26::views::transform_lut(is_space_fn()),
+                         [&spaces](bool b) { spaces.push_back(b); });
+    ASSERT_EQ(spaces.size(), chars.size());
+    for (std::size_t i = 0; i < chars.size(); ++i) {
+        EXPECT_EQ(lower[i], to_lower_fn()(chars[i]));
+        EXPECT_EQ(spaces[i], is_space_fn()(chars[i]));
+    }
+}
+
+TEST(lut_, wide_input) {
+    std::vector<std::uint16_t> ints = {0, 1, 0xff, 0x100, 0xffff, 0x8001};
+    auto view = ints | tv26::views::transform_lut(popcount_fn());
+    std::vector<int> out(ints.size());
+    tv26::batch_copy(view, out.begin());
+    EXPECT_EQ(out, std::vector<int>({0, 1, 8, 1, 16, 2}));
+}
+
+#if BEMAN_TRANSFORM_VIEW_LUT_SHUFFLE
+TEST(lut_, shuffle_versions) {
+    // Runs each version the host supports, not only the one chosen.
+    using table = tv26::detail::lut_table<hash_byte_fn, unsigned char>;
+    __builtin_cpu_init();
+    struct version {
+        const char*                  isa;
+        bool                         supported;
+        tv26::detail::shuffle_lut_fn fn;
+    };
+    const version versions[] = {
+        {"sse4.1",
+         bool(__builtin_cpu_supports("sse4.1")),
+         &tv26::detail::shuffle_lut_sse41},
+        {"avx2",
+         bool(__builtin_cpu_supports("avx2")),
+         &tv26::detail::shuffle_lut_avx2},
+        {"avx512vbmi",
+         __builtin_cpu_supports("avx512bw") &&
+             __builtin_cpu_supports("avx512vbmi"),
+         &tv26::detail::shuffle_lut_avx512},
+    };
+
+    std::vector<unsigned char> bytes(256 * 3 + 17);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = static_cast<unsigned char>(i * 37 + 11);
+    for (const version& v : versions) {
+        if (!v.supported)
+            continue;
+        std::vector<unsigned char> out(bytes.size());
+        const std::size_t          done =
+            v.fn(table::values.data(), bytes.data(), bytes.size(), out.data());
+        EXPECT_GT(done, bytes.size() - 64) << v.isa;
+        for (std::size_t i = 0; i < done; ++i)
+            ASSERT_EQ(out[i], hash_byte_fn()(bytes[i])) << v.isa << ' ' << i;
+    }
+}
+#endif
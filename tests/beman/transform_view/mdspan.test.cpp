@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <version>
+#if __has_include(<mdspan>)
+#include <array>
+#include <cstddef>
+#include <mdspan>
+#include <numeric>
+#include <vector>
+#endif
+#endif
+
+#include <beman/transform_view/mdspan.hpp>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES() || defined(__cpp_lib_mdspan)
+
+namespace tv26 = beman::transform_view;
+
+namespace {
+
+struct scale_fn {
+    constexpr double operator()(int x) const { return 0.5 * x; }
+};
+
+struct plus_one_fn {
+    constexpr double operator()(double x) const { return x + 1; }
+};
+
+// A layout_right accessor that counts its accesses.
+struct counting_accessor {
+    using offset_policy    = std::default_accessor<int>;
+    using element_type     = int;
+    using reference        = int&;
+    using data_handle_type = int*;
+
+    int* count = nullptr;
+
+    constexpr reference access(int* p, std::size_t i) const {
+        ++*count;
+        return p[i];
+    }
+    constexpr int* offset(int* p, std::size_t i) const { return p + i; }
+};
+
+std::vector<int> iota_vector(std::size_t n) {
+    std::vector<int> v(n);
+    std::iota(v.begin(), v.end(), 0);
+    return v;
+}
+
+} // namespace
+
+TEST(mdspan_, same_extents_and_lazy) {
+    auto v  = iota_vector(12);
+    auto md = std::mdspan(v.data(), 3, 4);
+
+    auto t = tv26::transform_mdspan(md, scale_fn{});
+    static_assert(decltype(t)::rank() == 2);
+    static_assert(std::same_as<decltype(t)::reference, double>);
+    static_assert(sizeof(t) == sizeof(md));
+    EXPECT_EQ(t.extents(), md.extents());
+
+    EXPECT_EQ((t[2, 3]), 5.5);
+    v[11] = 20;
+    EXPECT_EQ((t[2, 3]), 10.0);
+}
+
+TEST(mdspan_, composes) {
+    auto v = iota_vector(6);
+    auto t = tv26::transform_mdspan(
+        tv26::transform_mdspan(std::mdspan(v.data(), 2, 3), scale_fn{}),
+        plus_one_fn{});
+    EXPECT_EQ((t[1, 1]), 3.0);
+}
+
+TEST(mdspan_, stateful_function) {
+    auto v      = iota_vector(4);
+    int  offset = 100;
+    auto t      = tv26::transform_mdspan(std::mdspan(v.data(), 4),
+                                    [offset](int x) { return x + offset; });
+    EXPECT_EQ(t[3], 103);
+}
+
+TEST(mdspan_, materialize_layouts) {
+    constexpr std::size_t rows = 37, cols = 70;
+    auto                  v = iota_vector(rows * cols);
+    using ext_t             = std::dextents<std::size_t, 2>;
+    ext_t e(rows, cols);
+
+    auto src = tv26::transform_mdspan(
+        std::mdspan<int, ext_t, std::layout_right>(v.data(), e), scale_fn{});
+
+    std::vector<double> right(rows * cols), left(rows * cols);
+    tv26::materialize(src,
+                      std::mdspan<double, ext_t, std::layout_right>(
+                          right.data(), e));
+    tv26::materialize(src,
+                      std::mdspan<double, ext_t, std::layout_left>(
+                          left.data(), e));
+
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < cols; ++j) {
+            ASSERT_EQ(right[i * cols + j], 0.5 * double(i * cols + j));
+            ASSERT_EQ(left[j * rows + i], 0.5 * double(i * cols + j));
+        }
+    }
+}
+
+TEST(mdspan_, materialize_strided) {
+    // A 3-D array stored with its middle dimension fastest, copied into
+    // layout_right.
+    constexpr std::size_t a = 3, b = 40, c = 33;
+    auto                  v = iota_vector(a * b * c);
+    using ext_t             = std::dextents<std::size_t, 3>;
+    ext_t                         e(a, b, c);
+    std::array<std::size_t, 3>    strides{b * c, 1, b};
+    std::layout_stride::mapping<ext_t> m(e, strides);
+    std::mdspan<int, ext_t, std::layout_stride> src(v.data(), m);
+
+    std::vector<int> out(a * b * c);
+    tv26::materialize(src, std::mdspan(out.data(), e));
+
+    for (std::size_t i = 0; i < a; ++i)
+        for (std::size_t j = 0; j < b; ++j)
+            for (std::size_t k = 0; k < c; ++k)
+                ASSERT_EQ(out[(i * b + j) * c + k],
+                          v[i * b * c + j + k * b]);
+}
+
+TEST(mdspan_, rank_zero) {
+    int  x   = 7;
+    auto src = tv26::transform_mdspan(std::mdspan<int, std::extents<int> >(&x),
+                                      scale_fn{});
+    double y = 0;
+    tv26::materialize(src, std::mdspan<double, std::extents<int> >(&y));
+    EXPECT_EQ(y, 3.5);
+    EXPECT_EQ(tv26::reduce(tv26::unordered, src, 1.0), 4.5);
+}
+
+TEST(mdspan_, reduce) {
+    constexpr std::size_t rows = 19, cols = 23;
+    auto                  v = iota_vector(rows * cols);
+    using ext_t             = std::dextents<std::size_t, 2>;
+
+    const double expected = 0.5 * double(rows * cols * (rows * cols - 1) / 2);
+    auto right = tv26::transform_mdspan(std::mdspan(v.data(), rows, cols),
+                                        scale_fn{});
+    auto left  = tv26::transform_mdspan(
+        std::mdspan<int, ext_t, std::layout_left>(v.data(), rows, cols),
+        scale_fn{});
+    EXPECT_EQ(tv26::reduce(tv26::unordered, right, 0.0), expected);
+    EXPECT_EQ(tv26::reduce(tv26::unordered, left, 0.0), expected);
+    EXPECT_EQ(tv26::reduce<1>(tv26::unordered,
+                              left,
+                              0.0,
+                              [](double x, double y) { return x + y; }),
+              expected);
+}
+
+TEST(mdspan_, each_element_once) {
+    constexpr std::size_t rows = 50, cols = 45;
+    auto                  v     = iota_vector(rows * cols);
+    int                   count = 0;
+    using ext_t                 = std::dextents<std::size_t, 2>;
+    std::mdspan<int, ext_t, std::layout_right, counting_accessor> md(
+        v.data(), std::layout_right::mapping<ext_t>(ext_t(rows, cols)),
+        counting_accessor{&count});
+
+    std::vector<double> out(rows * cols);
+    tv26::materialize(
+        tv26::transform_mdspan(md, scale_fn{}),
+        std::mdspan<double, ext_t, std::layout_left>(out.data(), rows, cols));
+    EXPECT_EQ(count, int(rows * cols));
+
+    count = 0;
+    EXPECT_EQ(tv26::reduce(tv26::unordered, md, 0L),
+              long(rows * cols * (rows * cols - 1) / 2));
+    EXPECT_EQ(count, int(rows * cols));
+}
+
+#endif
@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+#endif
+
+#include <beman/transform_view/mpmc_queue.hpp>
+
+namespace tv26 = beman::transform_view;
+
+namespace {
+
+// Counts the live objects of its type.
+struct tracked {
+    static inline std::atomic<int> live{0};
+
+    int value;
+
+    explicit tracked(int v) : value(v) { ++live; }
+    tracked(tracked&& other) noexcept : value(other.value) { ++live; }
+    ~tracked() { --live; }
+};
+
+// Counts its calls.
+struct counted {
+    std::atomic<int>* calls;
+
+    int operator()(int x) const {
+        calls->fetch_add(1, std::memory_order_relaxed);
+        return 2 * x;
+    }
+};
+
+} // namespace
+
+TEST(mpmc_queue_, concepts) {
+    using V = tv26::drain_view<int>;
+    static_assert(std::ranges::input_range<V>);
+    static_assert(!std::ranges::forward_range<V>);
+    static_assert(std::ranges::view<V>);
+    static_assert(!std::copyable<V>);
+    static_assert(std::same_as<std::ranges::range_reference_t<V>, int&>);
+
+    tv26::mpmc_queue<int> q(8);
+    using T = decltype(tv26::views::drain(q) | tv26::views::transform(
+                                                  [](int x) { return x; }));
+    static_assert(std::ranges::input_range<T>);
+}
+
+TEST(mpmc_queue_, single_thread) {
+    tv26::mpmc_queue<std::string> q(5);
+    EXPECT_EQ(q.capacity(), 8u);
+    EXPECT_FALSE(q.try_pop());
+
+    // Several laps round the ring.
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 8; ++i)
+            EXPECT_TRUE(q.try_push(std::to_string(i)));
+        std::string x = "full";
+        EXPECT_FALSE(q.try_push(std::move(x)));
+        EXPECT_EQ(x, "full");
+        for (int i = 0; i < 8; ++i)
+            EXPECT_EQ(q.try_pop(), std::to_string(i));
+        EXPECT_FALSE(q.try_pop());
+    }
+
+    const std::string last = "last";
+    EXPECT_TRUE(q.push(last));
+    q.close();
+    EXPECT_TRUE(q.closed());
+    EXPECT_FALSE(q.push(std::string("late")));
+    EXPECT_EQ(q.pop(), "last");
+    EXPECT_EQ(q.pop(), std::nullopt);
+}
+
+TEST(mpmc_queue_, drain_batches) {
+    tv26::mpmc_queue<int> q(16);
+    std::atomic<int>      calls{0};
+    for (std::size_t batch :
+         {std::size_t(1), std::size_t(5), std::size_t(64)}) {
+        std::thread producer([&] {
+            for (int i = 0; i < 1000; ++i)
+                EXPECT_TRUE(q.push(i));
+        });
+        std::vector<int> out;
+        calls = 0;
+        for (int x : tv26::views::drain(q, batch) |
+                         tv26::views::transform(counted{&calls})) {
+            out.push_back(x);
+            if (out.size() == 1000)
+                break;
+        }
+        producer.join();
+        EXPECT_EQ(calls.load(), 1000);
+        ASSERT_EQ(out.size(), 1000u);
+        for (int i = 0; i < 1000; ++i)
+            ASSERT_EQ(out[std::size_t(i)], 2 * i) << batch;
+    }
+
+    q.push(7);
+    q.close();
+    std::vector<int> rest;
+    for (int x : tv26::views::drain(q))
+        rest.push_back(x);
+    EXPECT_EQ(rest, std::vector<int>{7});
+}
+
+TEST(mpmc_queue_, many_producers_and_consumers) {
+    constexpr int         producers = 4;
+    constexpr int         per       = 20000;
+    tv26::mpmc_queue<int> q(64);
+
+    std::vector<std::atomic<int> > seen(producers * per);
+    std::atomic<int>               popped{0};
+    std::vector<std::thread>       threads;
+    for (int c = 0; c < 3; ++c) {
+        threads.emplace_back([&, c] {
+            if (c == 0) {
+                while (std::optional<int> x = q.pop()) {
+                    seen[std::size_t(*x)].fetch_add(1);
+                    popped.fetch_add(1);
+                }
+            } else {
+                for (int& x : tv26::views::drain(q, std::size_t(c * 8))) {
+                    seen[std::size_t(x)].fetch_add(1);
+                    popped.fetch_add(1);
+                }
+            }
+        });
+    }
+    std::vector<std::thread> pushers;
+    for (int p = 0; p < producers; ++p) {
+        pushers.emplace_back([&, p] {
+            for (int i = 0; i < per; ++i)
+                EXPECT_TRUE(q.push(p * per + i));
+        });
+    }
+    for (std::thread& t : pushers)
+        t.join();
+    q.close();
+    for (std::thread& t : threads)
+        t.join();
+
+    EXPECT_EQ(popped.load(), producers * per);
+    for (std::size_t i = 0; i < seen.size(); ++i)
+        ASSERT_EQ(seen[i].load(), 1) << i;
+}
+
+TEST(mpmc_queue_, close_wakes_waiters) {
+    tv26::mpmc_queue<int> full(2);
+    full.push(1);
+    full.push(2);
+    std::thread pusher([&] { EXPECT_FALSE(full.push(3)); });
+
+    tv26::mpmc_queue<int> empty(2);
+    std::thread           popper([&] { EXPECT_EQ(empty.pop(), std::nullopt); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    full.close();
+    empty.close();
+    pusher.join();
+    popper.join();
+    EXPECT_EQ(full.pop(), 1);
+    EXPECT_EQ(full.pop(), 2);
+    EXPECT_EQ(full.pop(), std::nullopt);
+}
+
+TEST(mpmc_queue_, destroys_elements) {
+    {
+        tv26::mpmc_queue<tracked> q(8);
+        for (int i = 0; i < 6; ++i)
+            q.push(tracked(i));
+        {
+            // Claims four, reaches two.
+            auto drained = tv26::views::drain(q, 4);
+            auto it      = drained.begin();
+            EXPECT_EQ((*it).value, 0);
+            ++it;
+            EXPECT_EQ((*it).value, 1);
+            EXPECT_EQ(tracked::live.load(), 5);
+        }
+        EXPECT_EQ(tracked::live.load(), 2);
+        EXPECT_EQ(q.try_pop()->value, 4);
+    }
+    EXPECT_EQ(tracked::live.load(), 0);
+}
@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#endif
+
+#include <beman/transform_view/pipelined.hpp>
+
+namespace tv26 = beman::transform_view;
+
+namespace {
+
+// Records the thread it last ran on.
+struct record_thread {
+    std::thread::id* id;
+
+    int operator()(int x) const {
+        *id = std::this_thread::get_id();
+        return x + 1;
+    }
+};
+
+// Counts its calls.
+struct counted {
+    std::atomic<int>* calls;
+
+    int operator()(int x) const {
+        calls->fetch_add(1, std::memory_order_relaxed);
+        return x;
+    }
+};
+
+struct throw_at {
+    int at;
+
+    int operator()(int x) const {
+        if (x == at)
+            throw std::runtime_error("bad element");
+        return x;
+    }
+};
+
+auto decode = [](int x) { return std::to_string(x); };
+auto parse  = [](const std::string& s) { return std::stoi(s) * 2; };
+auto enrich = [](int x) { return std::to_string(x) + "!"; };
+auto twice  = [](int x) { return 2 * x; };
+
+} // namespace
+
+TEST(pipelined_, concepts) {
+    using V = decltype(std::views::iota(0, 10) |
+                       tv26::views::transform(twice) |
+                       tv26::views::pipelined());
+    static_assert(std::ranges::input_range<V>);
+    static_assert(!std::ranges::forward_range<V>);
+    static_assert(std::ranges::view<V>);
+    static_assert(!std::copyable<V>);
+    static_assert(std::same_as<std::ranges::range_reference_t<V>, int&>);
+
+    // Not a chain of transforms.
+    static_assert(!tv26::detail::pipelinable<std::ranges::ref_view<
+                      std::vector<int> > >);
+}
+
+TEST(pipelined_, matches_sequential) {
+    std::vector<int> ints(100000);
+    for (std::size_t i = 0; i < ints.size(); ++i)
+        ints[i] = int(i);
+    auto chain = ints | tv26::views::transform(decode) |
+                 tv26::views::transform(parse) |
+                 tv26::views::transform(enrich);
+
+    std::vector<std::string> expected;
+    for (auto&& s : chain)
+        expected.push_back(s);
+
+    for (std::size_t batch :
+         {std::size_t(1), std::size_t(3), tv26::pipeline_batch}) {
+        std::vector<std::string> out;
+        for (auto& s : tv26::views::pipelined(chain, batch))
+            out.push_back(std::move(s));
+        EXPECT_EQ(out, expected) << batch;
+    }
+}
+
+TEST(pipelined_, single_pass_input) {
+    std::istringstream in("1 2 3 4 5 6 7 8 9 10");
+    auto view = std::views::istream<int>(in) | tv26::views::transform(decode) |
+                tv26::views::transform(parse) | tv26::views::pipelined(2);
+    std::vector<int> out;
+    for (int x : view)
+        out.push_back(x);
+    EXPECT_EQ(out, (std::vector<int>{2, 4, 6, 8, 10, 12, 14, 16, 18, 20}));
+}
+
+TEST(pipelined_, stage_per_thread) {
+    std::thread::id first, second;
+    auto view = std::views::iota(0, 1000) |
+                tv26::views::transform(record_thread{&first}) |
+                tv26::views::transform(record_thread{&second}) |
+                tv26::views::pipelined();
+    int sum = 0;
+    for (int x : view)
+        sum += x;
+    EXPECT_EQ(sum, 1000 * 999 / 2 + 2 * 1000);
+    // The threads have exited once the end is seen, so this does not race.
+    EXPECT_NE(first, std::thread::id());
+    EXPECT_NE(second, std::thread::id());
+    EXPECT_NE(first, second);
+    EXPECT_NE(first, std::this_thread::get_id());
+    EXPECT_NE(second, std::this_thread::get_id());
+}
+
+TEST(pipelined_, early_stop) {
+    // An unbounded source: destroying the view must stop and join the
+    // stages.
+    std::atomic<int> calls{0};
+    {
+        auto view = std::views::iota(0) |
+                    tv26::views::transform(counted{&calls}) |
+                    tv26::views::transform(twice) |
+                    tv26::views::pipelined(8);
+        int n = 0;
+        for (int x : view) {
+            EXPECT_EQ(x, 2 * n);
+            if (++n == 100)
+                break;
+        }
+    }
+    const int after = calls.load();
+    EXPECT_GE(after, 100);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(calls.load(), after);
+
+    // Never started.
+    auto unused = std::views::iota(0) | tv26::views::transform(twice) |
+                  tv26::views::pipelined();
+    (void)unused;
+}
+
+TEST(pipelined_, backpressure) {
+    std::atomic<int> calls{0};
+    constexpr std::size_t batch = 4;
+    auto view = std::views::iota(0, 10000) |
+                tv26::views::transform(counted{&calls}) |
+                tv26::views::transform(twice) |
+                tv26::views::pipelined(batch);
+    int consumed = 0;
+    for (int x : view) {
+        (void)x;
+        ++consumed;
+        if (consumed % 1000 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            // Two rings of 32 slots, plus an element in flight per stage.
+            EXPECT_LE(calls.load() - consumed, 2 * 32 + 2);
+        }
+    }
+    EXPECT_EQ(consumed, 10000);
+}
+
+TEST(pipelined_, exception) {
+    auto view = std::views::iota(0, 1000) |
+                tv26::views::transform(throw_at{500}) |
+                tv26::views::transform(twice) |
+                tv26::views::pipelined(16);
+    std::vector<int> out;
+    EXPECT_THROW(
+        {
+            for (int x : view)
+                out.push_back(x);
+        },
+        std::runtime_error);
+    ASSERT_EQ(out.size(), 500u);
+    EXPECT_EQ(out.back(), 2 * 499);
+}
+
+TEST(pipelined_, exceptions_in_two_stages) {
+    // The last stage throws first, and cancels the first, which throws
+    // shortly after; either exception may come out, but the first stage's
+    // must be read only once its thread has finished.
+    auto slow = [](int x) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return throw_at{11}(x);
+    };
+    auto view = std::views::iota(0, 1000) | tv26::views::transform(slow) |
+                tv26::views::transform(twice) |
+                tv26::views::transform(throw_at{20}) |
+                tv26::views::pipelined(1);
+    std::vector<int> out;
+    EXPECT_THROW(
+        {
+            for (int x : view)
+                out.push_back(x);
+        },
+        std::runtime_error);
+    EXPECT_EQ(out.size(), 10u);
+}
+
+TEST(pipelined_, move_only_results) {
+    auto view = std::views::iota(0, 100) |
+                tv26::views::transform(
+                    [](int x) { return std::make_unique<int>(x); }) |
+                tv26::views::transform(
+                    [](std::unique_ptr<int>&& p) { return std::move(p); }) |
+                tv26::views::pipelined(5);
+    int expected = 0;
+    for (std::unique_ptr<int>& p : view)
+        EXPECT_EQ(*p, expected++);
+    EXPECT_EQ(expected, 100);
+}
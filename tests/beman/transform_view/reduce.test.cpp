@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <cmath>
+#include <list>
+#include <numeric>
+#include <string>
+#include <vector>
+#endif
+
+#include <beman/transform_view/reduce.hpp>
+
+namespace tv26 = beman::transform_view;
+
+auto square_lambda = [](double x) { return x * x; };
+
+struct scale_func {
+    double factor;
+    double operator()(double x) const { return x * factor; }
+};
+
+std::vector<double> make_doubles(std::size_t n) {
+    std::vector<double> result(n);
+    for (std::size_t i = 0; i < n; ++i)
+        result[i] = 1.0 / double(i + 1);
+    return result;
+}
+
+TEST(reduce_, empty) {
+    std::vector<double> doubles;
+    EXPECT_EQ(tv26::reduce(doubles | tv26::views::transform(square_lambda),
+                           1.5),
+              1.5);
+    EXPECT_EQ(tv26::reduce(tv26::unordered,
+                           doubles | tv26::views::transform(square_lambda),
+                           1.5),
+              1.5);
+}
+
+TEST(reduce_, ordered_matches_fold) {
+    for (std::size_t n : {1u, 3u, 4u, 5u, 17u, 1000u}) {
+        auto doubles = make_doubles(n);
+        auto view    = doubles | tv26::views::transform(square_lambda);
+
+        double expected = 0.0;
+        for (double x : view)
+            expected = expected + x;
+
+        EXPECT_EQ(tv26::reduce(view, 0.0), expected);
+        EXPECT_EQ(tv26::reduce<8>(view, 0.0), expected);
+        EXPECT_EQ(tv26::reduce<1>(view, 0.0), expected);
+    }
+}
+
+TEST(reduce_, ordered_preserves_order) {
+    std::vector<int> ints = {1, 2, 3, 4, 5, 6, 7};
+    auto             view =
+        ints | tv26::views::transform([](int x) { return std::to_string(x); });
+    auto result = tv26::reduce(
+        view, std::string("0"), [](std::string acc, const std::string& x) {
+            return acc + x;
+        });
+    EXPECT_EQ(result, "01234567");
+}
+
+TEST(reduce_, unordered) {
+    for (std::size_t n : {1u, 3u, 4u, 5u, 17u, 1000u}) {
+        auto doubles = make_doubles(n);
+        auto view    = doubles | tv26::views::transform(square_lambda);
+
+        const double expected = tv26::reduce(view, 0.0);
+        EXPECT_NEAR(tv26::reduce(tv26::unordered, view, 0.0), expected, 1e-12);
+        EXPECT_NEAR(
+            tv26::reduce<8>(tv26::unordered, view, 0.0), expected, 1e-12);
+    }
+
+    std::vector<long> longs(101);
+    std::iota(longs.begin(), longs.end(), 0);
+    EXPECT_EQ(tv26::reduce(tv26::unordered,
+                           longs | tv26::views::transform(
+                                       [](long x) { return x * 2; }),
+                           1L),
+              1L + 100L * 101L);
+}
+
+TEST(reduce_, stateful_func) {
+    auto doubles = make_doubles(10);
+    auto view    = doubles | tv26::views::transform(scale_func{2.0});
+    static_assert(!tv26::detail::tidy_func<scale_func>);
+
+    double expected = 0.0;
+    for (double x : doubles)
+        expected += x * 2.0;
+    EXPECT_EQ(tv26::reduce(view, 0.0), expected);
+    EXPECT_NEAR(tv26::reduce(tv26::unordered, view, 0.0), expected, 1e-12);
+}
+
+TEST(reduce_, norm) {
+    std::vector<double> doubles = {3.0, 4.0, 12.0};
+    const auto          sum_sq  = tv26::reduce(
+        tv26::unordered, doubles | tv26::views::transform(square_lambda), 0.0);
+    EXPECT_EQ(std::sqrt(sum_sq), 13.0);
+}
+
+TEST(reduce_, non_random_access) {
+    std::list<int> ints = {1, 2, 3, 4, 5};
+    auto view = ints | tv26::views::transform([](int x) { return x * x; });
+    EXPECT_EQ(tv26::reduce(view, 0), 55);
+    EXPECT_EQ(tv26::reduce(tv26::unordered, view, 0), 55);
+    EXPECT_EQ(tv26::reduce(view, 1, std::multiplies<>{}), 14400);
+}
+
+TEST(reduce_, plain_range) {
+    std::vector<int> ints = {1, 2, 3, 4, 5, 6, 7};
+    EXPECT_EQ(tv26::reduce(ints, 0), 28);
+    EXPECT_EQ(tv26::reduce(tv26::unordered, ints, 0), 28);
+}
+
+TEST(reduce_, constexpr_) {
+    static_assert([] {
+        int arr[] = {1, 2, 3, 4, 5, 6};
+        return tv26::reduce(tv26::unordered,
+                            arr | tv26::views::transform(
+                                      [](int x) { return x + 1; }),
+                            0);
+    }() == 27);
+}
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#endif
+
+#include <beman/transform_view/sort_by_cached_key.hpp>
+
+namespace tv26 = beman::transform_view;
+
+auto normalize_lambda = [](const std::string& s) {
+    std::string result;
+    for (char c : s) {
+        if (c != ' ')
+            result += char(std::tolower((unsigned char)c));
+    }
+    return result;
+};
+
+struct counting_key {
+    int* calls;
+
+    int operator()(int x) const {
+        ++*calls;
+        return x % 10;
+    }
+};
+
+TEST(sort_by_cached_key_, sort) {
+    std::vector<std::string> strs = {"b A", "A", "C", "a a", "ba"};
+    auto last = tv26::sort_by_cached_key(strs, normalize_lambda);
+    EXPECT_EQ(last, strs.end());
+
+    std::vector<std::string> keys;
+    for (const auto& s : strs)
+        keys.push_back(normalize_lambda(s));
+    EXPECT_TRUE(std::ranges::is_sorted(keys));
+    EXPECT_EQ(strs[0], "A");
+    EXPECT_EQ(strs[1], "a a");
+    EXPECT_EQ(strs.back(), "C");
+}
+
+TEST(sort_by_cached_key_, calls_key_once_per_element) {
+    std::vector<int> ints;
+    for (int i = 0; i < 1000; ++i)
+        ints.push_back((i * 7919) % 1000);
+
+    int calls = 0;
+    tv26::sort_by_cached_key(ints, counting_key{&calls});
+    EXPECT_EQ(calls, 1000);
+    EXPECT_TRUE(std::ranges::is_sorted(ints, {}, [](int x) { return x % 10; }));
+
+    calls = 0;
+    tv26::stable_sort_by_cached_key(ints, counting_key{&calls});
+    EXPECT_EQ(calls, 1000);
+
+    calls = 0;
+    tv26::partial_sort_by_cached_key(
+        ints, ints.begin() + 10, counting_key{&calls});
+    EXPECT_EQ(calls, 1000);
+}
+
+TEST(sort_by_cached_key_, stable) {
+    std::vector<int> ints = {31, 12, 21, 42, 11, 32, 22, 41};
+    tv26::stable_sort_by_cached_key(ints, [](int x) { return x % 10; });
+    EXPECT_EQ(ints, std::vector<int>({31, 21, 11, 41, 12, 42, 32, 22}));
+}
+
+TEST(sort_by_cached_key_, comparator) {
+    std::vector<int> ints = {3, -1, 4, -1, 5, -9, 2, 6};
+    tv26::stable_sort_by_cached_key(
+        ints, [](int x) { return x < 0 ? -x : x; }, std::ranges::greater{});
+    EXPECT_EQ(ints, std::vector<int>({-9, 6, 5, 4, 3, 2, -1, -1}));
+}
+
+TEST(sort_by_cached_key_, partial) {
+    std::vector<int> ints = {9, 3, 7, 1, 8, 2, 6, 4, 5, 0};
+    auto             last = tv26::partial_sort_by_cached_key(
+        ints, ints.begin() + 3, [](int x) { return -x; });
+    EXPECT_EQ(last, ints.end());
+    EXPECT_EQ(std::vector<int>(ints.begin(), ints.begin() + 3),
+              std::vector<int>({9, 8, 7}));
+
+    std::vector<int> sorted = ints;
+    std::ranges::sort(sorted);
+    EXPECT_EQ(sorted, std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(sort_by_cached_key_, move_only_elements) {
+    std::vector<std::unique_ptr<int>> ptrs;
+    for (int i : {5, 3, 4, 1, 2})
+        ptrs.push_back(std::make_unique<int>(i));
+
+    tv26::sort_by_cached_key(ptrs, [](const auto& p) { return *p; });
+    for (int i = 0; i < 5; ++i)
+        EXPECT_EQ(*ptrs[std::size_t(i)], i + 1);
+}
+
+TEST(sort_by_cached_key_, member_pointer_key) {
+    struct record {
+        std::string name;
+        int         id;
+    };
+    std::vector<record> records = {{"c", 3}, {"a", 1}, {"b", 2}};
+    tv26::sort_by_cached_key(records, &record::id);
+    EXPECT_EQ(records[0].name, "a");
+    EXPECT_EQ(records[1].name, "b");
+    EXPECT_EQ(records[2].name, "c");
+}
+
+TEST(sort_by_cached_key_, dangling) {
+    auto result = tv26::sort_by_cached_key(std::vector<int>({2, 1}),
+                                           [](int x) { return x; });
+    static_assert(std::same_as<decltype(result), std::ranges::dangling>);
+}
@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <deque>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+#endif
+
+#include <beman/transform_view/split.hpp>
+
+namespace tv26 = beman::transform_view;
+
+auto square_lambda = [](int x) { return x * x; };
+
+struct add_func {
+    int offset;
+    int operator()(int x) const { return x + offset; }
+};
+
+template <typename R>
+std::vector<int> to_vector(R&& r) {
+    std::vector<int> result;
+    for (auto&& x : r)
+        result.push_back(x);
+    return result;
+}
+
+struct move_only_func {
+    std::unique_ptr<int> offset;
+    int operator()(int x) const { return x + *offset; }
+};
+
+struct custom_range {
+    std::vector<int>* ints;
+
+    auto begin() const { return ints->begin(); }
+    auto end() const { return ints->end(); }
+
+    std::pair<custom_range, custom_range> split_at(std::ptrdiff_t) const {
+        return {*this, *this};
+    }
+};
+
+TEST(split_, split_at_span_base) {
+    std::vector<int> ints = {1, 2, 3, 4, 5};
+    auto             view = tv26::transform_view(std::span(ints), square_lambda);
+
+    auto [head, tail] = tv26::split_at(view, 2);
+    static_assert(std::same_as<decltype(head), decltype(view)>);
+    static_assert(std::same_as<decltype(tail), decltype(view)>);
+    static_assert(std::ranges::borrowed_range<decltype(head)>);
+    EXPECT_EQ(to_vector(head), std::vector<int>({1, 4}));
+    EXPECT_EQ(to_vector(tail), std::vector<int>({9, 16, 25}));
+    EXPECT_EQ(head.base().data(), ints.data());
+}
+
+TEST(split_, split_at_contiguous_base) {
+    std::vector<int> ints = {1, 2, 3, 4, 5};
+    auto             view = ints | tv26::views::transform(square_lambda);
+
+    auto [head, tail] = tv26::split_at(view, 3);
+    static_assert(
+        std::same_as<decltype(head),
+                     tv26::transform_view<std::span<int>,
+                                          decltype(square_lambda)> >);
+    static_assert(std::ranges::borrowed_range<decltype(head)>);
+    EXPECT_EQ(to_vector(head), std::vector<int>({1, 4, 9}));
+    EXPECT_EQ(to_vector(tail), std::vector<int>({16, 25}));
+}
+
+TEST(split_, split_at_random_access_base) {
+    std::deque<int> ints = {1, 2, 3, 4};
+    auto            view = ints | tv26::views::transform(square_lambda);
+
+    auto [head, tail] = tv26::split_at(view, 1);
+    static_assert(
+        std::same_as<decltype(head.base()),
+                     std::ranges::subrange<std::deque<int>::iterator> >);
+    EXPECT_EQ(to_vector(head), std::vector<int>({1}));
+    EXPECT_EQ(to_vector(tail), std::vector<int>({4, 9, 16}));
+}
+
+TEST(split_, split_at_stateful_func) {
+    std::vector<int> ints = {1, 2, 3};
+    auto             view = ints | tv26::views::transform(add_func{10});
+
+    auto [head, tail] = tv26::split_at(view, 1);
+    static_assert(!std::ranges::borrowed_range<decltype(head)>);
+    EXPECT_EQ(to_vector(head), std::vector<int>({11}));
+    EXPECT_EQ(to_vector(tail), std::vector<int>({12, 13}));
+}
+
+TEST(split_, split_at_plain_view) {
+    std::string_view str = "hello";
+    auto [head, tail]    = tv26::split_at(str, 2);
+    static_assert(std::same_as<decltype(head), std::string_view>);
+    EXPECT_EQ(head, "he");
+    EXPECT_EQ(tail, "llo");
+}
+
+TEST(split_, split_at_constraints) {
+    using list_view = decltype(std::declval<std::list<int>&>() |
+                               tv26::views::transform(square_lambda));
+    static_assert(!std::invocable<decltype(tv26::split_at),
+                                  list_view&,
+                                  std::ptrdiff_t>);
+
+    using owning_view = decltype(std::declval<std::vector<int> >() |
+                                 tv26::views::transform(square_lambda));
+    static_assert(std::invocable<decltype(tv26::split_at),
+                                 owning_view&,
+                                 std::ptrdiff_t>);
+    static_assert(!std::invocable<decltype(tv26::split_at),
+                                  owning_view,
+                                  std::ptrdiff_t>);
+
+    // Each half would need a copy of the callable.
+    using move_only_view =
+        tv26::transform_view<std::span<int>, move_only_func>;
+    static_assert(!std::invocable<decltype(tv26::split_at),
+                                  move_only_view&,
+                                  std::ptrdiff_t>);
+    static_assert(!std::invocable<decltype(tv26::split),
+                                  move_only_view&,
+                                  std::size_t>);
+}
+
+TEST(split_, split_at_customization) {
+    std::vector<int> ints = {1, 2};
+    custom_range     r{&ints};
+    auto [head, tail] = tv26::split_at(r, 1);
+    EXPECT_EQ(head.ints, &ints);
+    EXPECT_EQ(tail.ints, &ints);
+}
+
+TEST(split_, split) {
+    std::vector<int> ints(10);
+    std::iota(ints.begin(), ints.end(), 0);
+    auto view = ints | tv26::views::transform(square_lambda);
+
+    EXPECT_TRUE(tv26::split(view, 0).empty());
+
+    auto pieces = tv26::split(view, 3);
+    ASSERT_EQ(pieces.size(), 3u);
+    EXPECT_EQ(to_vector(pieces[0]), std::vector<int>({0, 1, 4, 9}));
+    EXPECT_EQ(to_vector(pieces[1]), std::vector<int>({16, 25, 36}));
+    EXPECT_EQ(to_vector(pieces[2]), std::vector<int>({49, 64, 81}));
+
+    auto many = tv26::split(view, 12);
+    ASSERT_EQ(many.size(), 12u);
+    EXPECT_EQ(many[9].size(), 1u);
+    EXPECT_TRUE(many[10].empty());
+    EXPECT_TRUE(many[11].empty());
+}
+
+TEST(split_, parallel_pieces) {
+    std::vector<int> ints(1000);
+    std::iota(ints.begin(), ints.end(), 0);
+    auto view = ints | tv26::views::transform(square_lambda);
+
+    auto                     pieces = tv26::split(view, 4);
+    std::vector<long>        sums(pieces.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < pieces.size(); ++i) {
+        threads.emplace_back([piece = pieces[i], &sum = sums[i]] {
+            sum = 0;
+            for (int x : piece)
+                sum += x;
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    EXPECT_EQ(std::accumulate(sums.begin(), sums.end(), 0L), 332833500L);
+}
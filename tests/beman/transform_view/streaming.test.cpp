@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <span>
+#include <vector>
+#endif
+
+#include <beman/transform_view/streaming.hpp>
+
+namespace tv26 = beman::transform_view;
+
+namespace {
+
+struct rgb {
+    std::uint8_t r, g, b;
+
+    friend bool operator==(const rgb&, const rgb&) = default;
+};
+
+struct to_rgb_fn {
+    rgb operator()(int i) const {
+        return rgb{std::uint8_t(i), std::uint8_t(i >> 8), std::uint8_t(i * 7)};
+    }
+};
+
+struct square_fn {
+    long long operator()(int i) const { return (long long)i * i; }
+};
+
+template <typename R, typename Out>
+concept can_materialize = requires(R r, Out out) {
+    tv26::materialize_streaming(r, (Out&&)out);
+};
+
+} // namespace
+
+TEST(streaming_, below_threshold) {
+    std::vector<int> v{1, 2, 3, 4};
+    std::vector<int> out(6, -1);
+
+    auto rest = tv26::materialize_streaming(
+        v | tv26::views::transform([](int x) { return 2 * x; }), out);
+
+    EXPECT_EQ(out, (std::vector<int>{2, 4, 6, 8, -1, -1}));
+    EXPECT_EQ(rest.data(), out.data() + 4);
+    EXPECT_EQ(rest.size(), 2u);
+}
+
+TEST(streaming_, every_alignment_and_size) {
+    // A threshold of 0 forces the streaming path.  Writing bytes at each
+    // offset within a cache line exercises every head; the sizes cover
+    // outputs shorter than a line, and several staging buffers.
+    auto byte_at = [](int i) { return (unsigned char)(i * 31 + (i >> 8)); };
+    std::vector<unsigned char> buffer(70000 + 192);
+    for (int n : {0, 1, 15, 16, 17, 63, 64, 65, 200, 16384, 16447, 70000}) {
+        for (std::size_t offset : {0, 1, 8, 13, 32, 63}) {
+            std::fill(buffer.begin(), buffer.end(), 0xcc);
+            unsigned char* p = buffer.data() + 64 -
+                               std::uintptr_t(buffer.data()) % 64 + offset;
+
+            auto rest = tv26::materialize_streaming(
+                std::views::iota(0, n) | tv26::views::transform(byte_at),
+                std::span(p, std::size_t(n) + 1),
+                0);
+
+            ASSERT_EQ(rest.data(), p + n);
+            for (int i = 0; i < n; ++i)
+                ASSERT_EQ(p[i], byte_at(i)) << n << ' ' << offset << ' ' << i;
+            ASSERT_EQ(p[-1], 0xcc) << n << ' ' << offset;
+            ASSERT_EQ(p[n], 0xcc) << n << ' ' << offset;
+        }
+    }
+}
+
+TEST(streaming_, wide_elements) {
+    for (int n : {0, 1, 7, 8, 9, 2047, 2048, 2049, 10000}) {
+        auto out = std::vector<long long>(std::size_t(n));
+        tv26::materialize_streaming(
+            std::views::iota(0, n) | tv26::views::transform(square_fn{}),
+            out,
+            0);
+        for (int i = 0; i < n; ++i)
+            ASSERT_EQ(out[std::size_t(i)], (long long)i * i) << n << ' ' << i;
+    }
+}
+
+TEST(streaming_, odd_sized_elements) {
+    // 3-byte elements never line up with the cache lines they straddle.
+    for (int n : {0, 1, 21, 22, 5461, 5462, 5463, 20000}) {
+        auto out = std::vector<rgb>(std::size_t(n));
+        tv26::materialize_streaming(
+            std::views::iota(0, n) | tv26::views::transform(to_rgb_fn{}),
+            out,
+            0);
+        for (int i = 0; i < n; ++i)
+            ASSERT_EQ(out[std::size_t(i)], to_rgb_fn{}(i)) << n << ' ' << i;
+    }
+}
+
+TEST(streaming_, above_default_threshold) {
+    const auto n = int(tv26::streaming_threshold / sizeof(int)) + 1000;
+    auto out = std::vector<int>(std::size_t(n));
+
+    tv26::materialize_streaming(std::views::iota(0, n) |
+                                    tv26::views::transform(
+                                        [](int x) { return x ^ 0x5a5a; }),
+                                out);
+
+    for (int i = 0; i < n; ++i)
+        ASSERT_EQ(out[std::size_t(i)], i ^ 0x5a5a);
+}
+
+TEST(streaming_, input_range) {
+    std::list<int>     l{3, 1, 4, 1, 5};
+    std::array<int, 5> out{};
+
+    tv26::materialize_streaming(
+        l | tv26::views::transform([](int x) { return x + 1; }), out, 0);
+
+    EXPECT_EQ(out, (std::array<int, 5>{4, 2, 5, 2, 6}));
+}
+
+TEST(streaming_, constraints) {
+    using view_t = decltype(std::views::iota(0, 1) |
+                            tv26::views::transform(square_fn{}));
+    using vector_view_t =
+        decltype(std::views::iota(0, 1) |
+                 tv26::views::transform([](int) { return std::vector<int>(); }));
+
+    static_assert(can_materialize<view_t, std::vector<long long>&>);
+    static_assert(can_materialize<view_t, std::span<long long> >);
+    // The output must be contiguous...
+    static_assert(!can_materialize<view_t, std::list<long long>&>);
+    // ...and trivially copyable.
+    static_assert(
+        !can_materialize<vector_view_t, std::vector<std::vector<int> >&>);
+}
@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <cstddef>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <vector>
+#endif
+
+#include <beman/transform_view/transform_into.hpp>
+
+namespace tv26 = beman::transform_view;
+
+namespace {
+
+void format_record(int x, std::string& out) {
+    out.clear();
+    out += "record ";
+    out += std::to_string(x);
+}
+
+auto format_lambda = [](int x, std::string& out) { format_record(x, out); };
+
+} // namespace
+
+TEST(transform_into_, concepts) {
+    using V = decltype(std::vector<int>() |
+                       tv26::views::transform_into(format_lambda));
+    static_assert(std::ranges::input_range<V>);
+    static_assert(!std::ranges::forward_range<V>);
+    static_assert(std::ranges::view<V>);
+    static_assert(std::ranges::sized_range<V>);
+    static_assert(!std::copyable<V>);
+    static_assert(
+        std::same_as<std::ranges::range_reference_t<V>, std::string&>);
+    static_assert(std::same_as<std::ranges::range_value_t<V>, std::string>);
+}
+
+TEST(transform_into_, elements) {
+    std::vector<int>         ints = {1, 22, 333};
+    std::vector<std::string> out;
+    for (const std::string& s :
+         ints | tv26::views::transform_into(format_lambda))
+        out.push_back(s);
+    EXPECT_EQ(out,
+              (std::vector<std::string>{
+                  "record 1", "record 22", "record 333"}));
+
+    auto view = tv26::views::transform_into(ints, &format_record);
+    EXPECT_EQ(view.size(), 3u);
+    EXPECT_EQ(*view.begin(), "record 1");
+
+    auto empty =
+        std::vector<int>() | tv26::views::transform_into(format_lambda);
+    EXPECT_TRUE(empty.begin() == empty.end());
+}
+
+TEST(transform_into_, reuses_storage) {
+    std::vector<int> ints(100);
+    for (std::size_t i = 0; i < ints.size(); ++i)
+        ints[i] = int(i % 7);
+
+    std::vector<int> initial;
+    initial.reserve(16);
+    const int* const storage = initial.data();
+
+    auto view = ints | tv26::views::transform_into(
+                           [](int n, std::vector<int>& out) {
+                               out.assign(std::size_t(n), n);
+                           },
+                           std::move(initial));
+    const std::vector<int>* first = nullptr;
+    int                     i     = 0;
+    for (std::vector<int>& v : view) {
+        if (first == nullptr)
+            first = &v;
+        EXPECT_EQ(&v, first);
+        EXPECT_EQ(v.data(), storage);
+        EXPECT_EQ(v, std::vector<int>(std::size_t(i % 7), i % 7));
+        ++i;
+    }
+    EXPECT_EQ(i, 100);
+}
+
+TEST(transform_into_, one_call_per_element) {
+    int  calls = 0;
+    auto view  = std::vector<int>{1, 2, 3} |
+                tv26::views::transform_into(
+                    [&calls](int x, std::string& out) {
+                        ++calls;
+                        format_record(x, out);
+                    });
+    auto it = view.begin();
+    EXPECT_EQ(*it, "record 1");
+    EXPECT_EQ(*it, "record 1");
+    EXPECT_EQ(calls, 1);
+
+    // Skipping an element without dereferencing it does not call f.
+    ++it;
+    ++it;
+    EXPECT_EQ(*it, "record 3");
+    EXPECT_EQ(calls, 2);
+    ++it;
+    EXPECT_TRUE(it == view.end());
+}
+
+TEST(transform_into_, generic_callable) {
+    // Out cannot be deduced from a generic callable, so it is given as a
+    // starting value.
+    std::istringstream in("3 1 2");
+    auto view = std::views::istream<int>(in) |
+                tv26::views::transform_into(
+                    [](auto x, auto& out) { out = std::string(x, '*'); },
+                    std::string());
+    std::vector<std::string> out;
+    for (std::string& s : view)
+        out.push_back(std::move(s));
+    EXPECT_EQ(out, (std::vector<std::string>{"***", "*", "**"}));
+}
+
+TEST(transform_into_, construct_directly) {
+    std::vector<int> ints = {5};
+    tv26::transform_into_view view(ints, format_lambda);
+    static_assert(std::same_as<decltype(view),
+                               tv26::transform_into_view<
+                                   std::ranges::ref_view<std::vector<int> >,
+                                   decltype(format_lambda),
+                                   std::string> >);
+    EXPECT_EQ(*view.begin(), "record 5");
+    EXPECT_EQ(view.base().size(), 1u);
+}
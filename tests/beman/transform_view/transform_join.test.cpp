@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <beman/transform_view/config.hpp>
+
+#include <gtest/gtest.h>
+
+#if BEMAN_TRANSFORM_VIEW_USE_MODULES()
+import std;
+#else
+#include <algorithm>
+#include <cstddef>
+#include <ranges>
+#include <sstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#endif
+
+#include <beman/transform_view/transform_join.hpp>
+
+namespace tv26 = beman::transform_view;
+
+namespace {
+
+// The words of a line, as views into it.
+struct first_word {
+    std::string_view operator()(std::string_view line) const {
+        return line.substr(0, line.find(' '));
+    }
+};
+
+struct as_span {
+    std::span<const int> operator()(const std::vector<int>& v) const {
+        return v;
+    }
+};
+
+std::vector<std::vector<int> > nested() {
+    return {{1, 2}, {}, {3}, {}, {}, {4, 5, 6}, {}};
+}
+
+} // namespace
+
+TEST(transform_join_, concepts) {
+    using V = decltype(std::declval<std::vector<std::vector<int> >&>() |
+                       tv26::views::transform_join(as_span()));
+    static_assert(
+        std::same_as<V,
+                     tv26::transform_join_view<
+                         std::ranges::ref_view<std::vector<std::vector<int> > >,
+                         as_span> >);
+    static_assert(std::ranges::forward_range<V>);
+    static_assert(std::ranges::forward_range<const V>);
+    static_assert(std::ranges::common_range<V>);
+    static_assert(std::ranges::borrowed_range<V>);
+    static_assert(
+        std::same_as<std::ranges::range_reference_t<V>, const int&>);
+    static_assert(std::same_as<std::ranges::iterator_t<V>::iterator_category,
+                               std::forward_iterator_tag>);
+
+    // The same thing through std::views::join is input-only, not const
+    // iterable, and not borrowed.
+    using J = decltype(std::views::join(
+        std::declval<std::vector<std::vector<int> >&>() |
+        tv26::views::transform(as_span())));
+    static_assert(!std::ranges::borrowed_range<J>);
+
+    // A callable that is not tidy does not make a borrowed view.
+    auto f  = [n = 0](const std::vector<int>& v) {
+        return std::span<const int>(v).subspan(std::size_t(n));
+    };
+    using W = decltype(std::declval<std::vector<std::vector<int> >&>() |
+                       tv26::views::transform_join(f));
+    static_assert(std::ranges::forward_range<W>);
+    static_assert(!std::ranges::borrowed_range<W>);
+}
+
+TEST(transform_join_, elements) {
+    const auto       v = nested();
+    std::vector<int> out;
+    for (int x : v | tv26::views::transform_join(as_span()))
+        out.push_back(x);
+    EXPECT_EQ(out, (std::vector<int>{1, 2, 3, 4, 5, 6}));
+
+    const auto view = v | tv26::views::transform_join(as_span());
+    EXPECT_EQ(std::ranges::distance(view), 6);
+    EXPECT_TRUE(std::ranges::equal(view, out));
+
+    const std::vector<std::vector<int> > empties(3);
+    auto none = empties | tv26::views::transform_join(as_span());
+    EXPECT_TRUE(none.begin() == none.end());
+    EXPECT_TRUE(std::ranges::empty(none));
+}
+
+TEST(transform_join_, multipass) {
+    const auto v    = nested();
+    auto       view = v | tv26::views::transform_join(as_span());
+    auto       it   = std::ranges::find(view, 4);
+    auto       copy = it;
+    ++it;
+    EXPECT_EQ(*it, 5);
+    EXPECT_EQ(*copy, 4);
+    EXPECT_TRUE(std::next(copy) == it);
+    EXPECT_EQ(std::ranges::count_if(view, [](int x) { return x % 2; }), 3);
+}
+
+TEST(transform_join_, borrowed_iterators) {
+    const std::vector<std::string> lines = {"alpha beta", "gamma", "delta x"};
+    // The view is a temporary, but its iterators stay valid.
+    auto it = std::ranges::find(
+        lines | tv26::views::transform_join(first_word()), 'g');
+    static_assert(!std::same_as<decltype(it), std::ranges::dangling>);
+    EXPECT_EQ(*it, 'g');
+    EXPECT_EQ(*++it, 'a');
+
+    std::string joined;
+    for (char c : lines | tv26::views::transform_join(first_word()))
+        joined += c;
+    EXPECT_EQ(joined, "alphagammadelta");
+}
+
+TEST(transform_join_, input_outer) {
+    // An input-only outer range whose elements are lvalues.
+    std::istringstream in("ab c def");
+    auto view = std::views::istream<std::string>(in) |
+                tv26::views::transform_join(
+                    [](const std::string& s) { return std::string_view(s); });
+    static_assert(!std::ranges::forward_range<decltype(view)>);
+    std::string out;
+    for (char c : view)
+        out += c;
+    EXPECT_EQ(out, "abcdef");
+}
+
+TEST(transform_join_, owning_inner_falls_back) {
+    // Inner ranges that own their elements go through std::views::join.
+    const std::vector<int> v = {1, 2, 3};
+    auto view = v | tv26::views::transform_join([](int n) {
+                    return std::vector<int>(std::size_t(n), n);
+                });
+    static_assert(!std::ranges::forward_range<decltype(view)>);
+    std::vector<int> out;
+    for (int x : view)
+        out.push_back(x);
+    EXPECT_EQ(out, (std::vector<int>{1, 2, 2, 3, 3, 3}));
+}
@@ -11,6 +11,9 @@ import std;
 #include <forward_list>
 #include <functional>
 #include <list>
+#include <memory>
+#include <ranges>
+#include <span>
 #include <string>
 #include <vector>
 #endif
@@ -344,6 +347,84 @@ TEST(transform_view_, begin_end) {
     }
 }
 
+TEST(transform_view_, sized_random_access_non_common) {
+    auto base = std::views::iota(0, 5L);
+    static_assert(!std::ranges::common_range<decltype(base)>);
+
+    auto view = tv26::transform_view(base, copy_lambda);
+    static_assert(std::ranges::common_range<decltype(view)>);
+    static_assert(std::ranges::common_range<const decltype(view)>);
+    static_assert(std::ranges::borrowed_range<decltype(view)>);
+    EXPECT_EQ(view.end() - view.begin(), 5);
+    EXPECT_EQ(view.end()[-1], 4);
+
+    std::vector<int> vec(view.begin(), view.end());
+    EXPECT_EQ(vec, std::vector<int>({0, 1, 2, 3, 4}));
+
+    const auto& const_view = view;
+    EXPECT_EQ(std::count_if(const_view.begin(),
+                            const_view.end(),
+                            [](int x) { return x % 2 == 0; }),
+              3);
+
+    auto add_one  = [n = 1](int x) { return x + n; };
+    auto stateful = tv26::transform_view(base, add_one);
+    static_assert(std::ranges::common_range<decltype(stateful)>);
+    EXPECT_EQ(*std::ranges::prev(stateful.end()), 5);
+}
+
+struct point {
+    int x;
+    int y;
+
+    int sum() const { return x + y; }
+};
+
+// Points at one point, but get() returns another.
+struct point_handle {
+    using type = point;
+
+    point* target;
+    point* other;
+
+    point& operator*() const { return *target; }
+    point& get() const { return *other; }
+};
+
+TEST(transform_view_, member_pointer_func) {
+    std::vector<point> points = {{1, 2}, {3, 4}};
+
+    auto xs = points | tv26::views::transform(&point::x);
+    EXPECT_EQ(xs[1], 3);
+    static_assert(std::same_as<decltype(xs[0]), int&>);
+    xs[0] = 5;
+    EXPECT_EQ(points[0].x, 5);
+
+    auto sums = points | tv26::views::transform(&point::sum);
+    EXPECT_EQ(sums[1], 7);
+
+    std::vector<point*> pointers = {&points[0], &points[1]};
+    auto ys = pointers | tv26::views::transform(&point::y);
+    EXPECT_EQ(ys[0], 2);
+    auto pointer_sums = pointers | tv26::views::transform(&point::sum);
+    EXPECT_EQ(pointer_sums[0], 7);
+
+    std::vector<std::reference_wrapper<point> > refs = {points[0], points[1]};
+    auto ref_ys = refs | tv26::views::transform(&point::y);
+    EXPECT_EQ(ref_ys[1], 4);
+    static_assert(std::same_as<decltype(ref_ys[0]), int&>);
+    auto ref_sums = refs | tv26::views::transform(&point::sum);
+    EXPECT_EQ(ref_sums[0], 7);
+
+    // Pointer-like, but with the members a std::reference_wrapper has: it is
+    // dereferenced, as std::invoke does, not unwrapped with get().
+    std::vector<point_handle> handles = {{&points[0], &points[1]}};
+    auto handle_ys = handles | tv26::views::transform(&point::y);
+    EXPECT_EQ(handle_ys[0], 2);
+    auto handle_sums = handles | tv26::views::transform(&point::sum);
+    EXPECT_EQ(handle_sums[0], 7);
+}
+
 TEST(transform_view_, copy_func_empty_range_copy_alg) {
     std::vector<int> ints;
 
@@ -575,6 +656,211 @@ TEST(transform_view_, borrowability_safety) {
     }
 }
 
+struct counting_func {
+    static inline int copies = 0;
+    static inline int moves  = 0;
+
+    static void reset() { copies = moves = 0; }
+
+    counting_func() = default;
+    counting_func(const counting_func&) { ++copies; }
+    counting_func(counting_func&&) noexcept { ++moves; }
+    counting_func& operator=(const counting_func&) {
+        ++copies;
+        return *this;
+    }
+    counting_func& operator=(counting_func&&) noexcept {
+        ++moves;
+        return *this;
+    }
+
+    int operator()(int x) const { return x + 1; }
+};
+
+struct move_only_func {
+    std::unique_ptr<int> offset = std::make_unique<int>(10);
+
+    int operator()(int x) const { return x + *offset; }
+};
+
+TEST(transform_view_, adaptor_moves_func) {
+    std::vector<int> vec = {1, 2, 3};
+
+    counting_func::reset();
+    {
+        counting_func f;
+        auto          view = vec | tv26::views::transform(std::move(f));
+        EXPECT_EQ(counting_func::copies, 0);
+        EXPECT_LE(counting_func::moves, 3);
+        EXPECT_EQ(*view.begin(), 2);
+    }
+
+    counting_func::reset();
+    {
+        counting_func f;
+        auto          view = tv26::views::transform(vec, std::move(f));
+        EXPECT_EQ(counting_func::copies, 0);
+        EXPECT_LE(counting_func::moves, 2);
+        EXPECT_EQ(*view.begin(), 2);
+    }
+
+    counting_func::reset();
+    {
+        auto view = vec | tv26::views::transform(counting_func());
+        EXPECT_EQ(counting_func::copies, 0);
+        EXPECT_LE(counting_func::moves, 3);
+        EXPECT_EQ(*view.begin(), 2);
+    }
+
+    // Reusing a closure lvalue must copy the callable, exactly once.
+    counting_func::reset();
+    {
+        const auto closure = tv26::views::transform(counting_func());
+        counting_func::reset();
+        auto view = vec | closure;
+        EXPECT_EQ(counting_func::copies, 1);
+        EXPECT_EQ(*view.begin(), 2);
+    }
+}
+
+TEST(transform_view_, adaptor_move_only_func) {
+    std::vector<int> vec  = {1, 2, 3};
+    auto             view = vec | tv26::views::transform(move_only_func());
+    static_assert(!std::copyable<decltype(view)>);
+    EXPECT_EQ(*view.begin(), 11);
+    EXPECT_EQ(*std::ranges::next(view.begin(), 2), 13);
+
+    auto view2 = tv26::views::transform(vec, move_only_func());
+    EXPECT_EQ(*view2.begin(), 11);
+
+    auto closure = tv26::views::transform(move_only_func());
+    auto view3   = vec | std::move(closure);
+    EXPECT_EQ(*view3.begin(), 11);
+}
+
+TEST(transform_view_, commute_reverse) {
+    std::vector<int> vec   = {1, 2, 3};
+    int              calls = 0;
+    auto             f     = [&calls](int x) {
+        ++calls;
+        return 2 * x;
+    };
+
+    auto view = vec | tv26::views::transform(f) | std::views::reverse;
+    static_assert(
+        std::same_as<decltype(view),
+                     tv26::transform_view<
+                         std::ranges::reverse_view<
+                             std::ranges::ref_view<std::vector<int> > >,
+                         decltype(f)> >);
+    std::vector<int> out;
+    for (int x : view)
+        out.push_back(x);
+    EXPECT_EQ(out, (std::vector<int>{6, 4, 2}));
+    EXPECT_EQ(calls, 3);
+
+    // Reversing twice gives back the original base.
+    auto twice = view | std::views::reverse;
+    static_assert(
+        std::same_as<decltype(twice),
+                     tv26::transform_view<
+                         std::ranges::ref_view<std::vector<int> >,
+                         decltype(f)> >);
+    EXPECT_EQ(*twice.begin(), 2);
+}
+
+TEST(transform_view_, commute_take_drop) {
+    std::vector<int> vec = {1, 2, 3, 4, 5};
+    using span_view =
+        tv26::transform_view<std::span<int>, decltype(copy_lambda)>;
+
+    auto taken =
+        vec | tv26::views::transform(copy_lambda) | std::views::take(2);
+    static_assert(
+        std::same_as<decltype(taken),
+                     tv26::transform_view<
+                         std::ranges::take_view<
+                             std::ranges::ref_view<std::vector<int> > >,
+                         decltype(copy_lambda)> >);
+    static_assert(std::ranges::borrowed_range<decltype(taken)>);
+    EXPECT_EQ(taken.size(), 2u);
+    EXPECT_EQ(taken[1], 2);
+
+    auto dropped = std::span(vec) | tv26::views::transform(copy_lambda) |
+                   std::views::drop(std::size_t(3));
+    static_assert(std::same_as<decltype(dropped), span_view>);
+    EXPECT_EQ(dropped.size(), 2u);
+    EXPECT_EQ(dropped[0], 4);
+
+    // A page of a window: still a single transform over a span.
+    auto page = std::span(vec) | tv26::views::transform(copy_lambda) |
+                std::views::drop(1) | std::views::take(3L);
+    static_assert(std::same_as<decltype(page), span_view>);
+    static_assert(std::ranges::borrowed_range<decltype(page)>);
+    std::vector<int> out(page.begin(), page.end());
+    EXPECT_EQ(out, (std::vector<int>{2, 3, 4}));
+
+    auto iota = std::views::iota(0, 100) | tv26::views::transform(copy_lambda) |
+                std::views::drop(10) | std::views::take(5);
+    static_assert(
+        std::same_as<decltype(iota),
+                     tv26::transform_view<std::ranges::iota_view<int, int>,
+                                          decltype(copy_lambda)> >);
+    EXPECT_EQ(iota.front(), 10);
+    EXPECT_EQ(iota.back(), 14);
+}
+
+#if defined(__cpp_lib_ranges_stride)
+TEST(transform_view_, commute_stride) {
+    std::vector<int> vec = {1, 2, 3, 4, 5};
+    auto             view =
+        vec | tv26::views::transform(copy_lambda) | std::views::stride(2);
+    static_assert(tv26::detail::transform_view_traits<
+                  decltype(view)>::is_transform_view);
+    std::vector<int> out(view.begin(), view.end());
+    EXPECT_EQ(out, (std::vector<int>{1, 3, 5}));
+}
+#endif
+
+TEST(transform_view_, commute_value_categories) {
+    std::vector<int> vec = {1, 2, 3};
+
+    const auto view  = std::span(vec) | tv26::views::transform(copy_lambda);
+    auto       taken = view | std::views::take(1);
+    static_assert(
+        std::same_as<decltype(taken),
+                     tv26::transform_view<std::span<int>,
+                                          decltype(copy_lambda)> >);
+    EXPECT_EQ(taken.size(), 1u);
+    EXPECT_EQ(view.size(), 3u);
+
+    auto mutable_view = vec | tv26::views::transform(copy_lambda);
+    EXPECT_EQ(*(mutable_view | std::views::reverse).begin(), 3);
+
+    // A move-only function is moved into the result.
+    auto move_only = vec | tv26::views::transform(move_only_func()) |
+                     std::views::reverse;
+    static_assert(tv26::detail::transform_view_traits<
+                  decltype(move_only)>::is_transform_view);
+    EXPECT_EQ(*move_only.begin(), 13);
+}
+
+TEST(transform_view_, commute_only_selection) {
+    std::vector<int> vec = {1, 2, 3};
+    auto             evens =
+        vec | tv26::views::transform(copy_lambda) |
+        std::views::filter([](int x) { return x % 2 == 0; });
+    static_assert(!tv26::detail::transform_view_traits<
+                  decltype(evens)>::is_transform_view);
+    EXPECT_EQ(*evens.begin(), 2);
+
+    auto small = vec | tv26::views::transform(copy_lambda) |
+                 std::views::take_while([](int x) { return x < 3; });
+    static_assert(!tv26::detail::transform_view_traits<
+                  decltype(small)>::is_transform_view);
+    EXPECT_EQ(std::ranges::distance(small), 2);
+}
+
 #if 0 // Enable this to see ASan catch the memory unsafety of using a
       // non-borrowable range.
 auto make_dangling_transform_view_subrange(const char* str) {